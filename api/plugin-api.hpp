@@ -148,6 +148,8 @@ struct OTR_API_EXPORT IProtocol : module_status_mixin
     // called 250 times a second with XYZ yaw pitch roll pose
     // try not to perform intense computation here. use a thread.
     virtual void pose(const double* headpose) = 0;
+    // return false to skip pose() when the pose is the same as last time
+    virtual bool repeat_unchanged_pose() { return true; }
     // return game name or placeholder text
     virtual QString game_name() = 0;
 };
@@ -233,6 +235,10 @@ struct OTR_API_EXPORT IExtension : module_status_mixin
 
     virtual event_mask hook_types() = 0;
 
+    // return true if process_*() only look at the pose. they're then called
+    // on a separate thread with a copy, and may miss poses if they're slow.
+    virtual bool observe_only() { return false; }
+
     virtual void process_raw(Pose&) {}
     virtual void process_before_filter(Pose&) {}
     virtual void process_before_mapping(Pose&) {}
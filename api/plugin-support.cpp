@@ -0,0 +1,152 @@
+/* Copyright (c) 2015 Stanislaw Halik
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#include "plugin-support.hpp"
+#include "options/group.hpp"
+
+#include <cstdlib>
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QLocale>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace plugin_api {
+namespace detail {
+
+// bump when changing the on-disk format
+static constexpr quint32 cache_magic = 0x6f74726du;
+static constexpr quint32 cache_version = 1;
+
+// translated names get stale if the ui language changes, or if translation
+// is turned off. same test as gui/init.cpp uses for loading the translator.
+static QString cache_locale()
+{
+    const bool translated = getenv("OTR_FORCE_LANG") ||
+        !options::group::with_global_settings_object([](QSettings& s) {
+            return s.value("disable-translation", false).toBool();
+        });
+
+    return translated ? QLocale().name() : QStringLiteral("untranslated");
+}
+
+module_cache::module_cache(const QString& library_path)
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+
+    if (dir.isEmpty() || !QDir(dir).mkpath(OPENTRACK_ORG))
+        return;
+
+    // separate cache per install location
+    const quint32 hash = qHash(QDir(library_path).canonicalPath());
+    pathname = QStringLiteral("%1/%2/module-cache-%3.dat")
+               .arg(dir).arg(OPENTRACK_ORG).arg(hash, 8, 16, QChar('0'));
+
+    load();
+}
+
+module_cache::~module_cache()
+{
+    // also drop entries for modules that went away
+    if (dirty || used.size() != entries.size())
+        save();
+}
+
+const module_cache::entry* module_cache::find(const QFileInfo& file)
+{
+    const QString path = file.canonicalFilePath();
+    auto it = entries.constFind(path);
+
+    if (it == entries.cend())
+        return nullptr;
+
+    if (it->size != file.size() || it->mtime != file.lastModified().toMSecsSinceEpoch())
+        return nullptr;
+
+    return &*used.insert(path, *it);
+}
+
+void module_cache::insert(const QFileInfo& file, const QString& name, const QIcon& icon)
+{
+    entry e;
+    e.name = name;
+    e.icon = icon;
+    e.size = file.size();
+    e.mtime = file.lastModified().toMSecsSinceEpoch();
+
+    used.insert(file.canonicalFilePath(), e);
+    dirty = true;
+}
+
+void module_cache::load()
+{
+    QFile f(pathname);
+
+    if (!f.open(QFile::ReadOnly))
+        return;
+
+    QDataStream s(&f);
+    s.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic = 0, version = 0;
+    QString locale;
+    quint32 count = 0;
+
+    s >> magic >> version >> locale >> count;
+
+    if (s.status() != QDataStream::Ok || magic != cache_magic || version != cache_version)
+        return;
+
+    if (locale != cache_locale())
+        return;
+
+    for (quint32 i = 0; i < count; i++)
+    {
+        QString path;
+        entry e;
+
+        s >> path >> e.name >> e.icon >> e.size >> e.mtime;
+
+        if (s.status() != QDataStream::Ok)
+        {
+            qDebug() << "module cache corrupt, ignoring" << pathname;
+            entries.clear();
+            return;
+        }
+
+        entries.insert(path, e);
+    }
+}
+
+void module_cache::save()
+{
+    if (pathname.isEmpty())
+        return;
+
+    // several instances may be starting at once, don't leave a torn file
+    QSaveFile f(pathname);
+
+    if (!f.open(QFile::WriteOnly))
+        return;
+
+    QDataStream s(&f);
+    s.setVersion(QDataStream::Qt_5_6);
+
+    s << cache_magic << cache_version << cache_locale() << quint32(used.size());
+
+    for (auto it = used.cbegin(); it != used.cend(); it++)
+        s << it.key() << it->name << it->icon << it->size << it->mtime;
+
+    if (s.status() != QDataStream::Ok || !f.commit())
+        qDebug() << "can't write module cache" << pathname;
+}
+
+} // ns detail
+} // ns plugin_api
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "plugin-api.hpp"
+#include "export.hpp"
 
 #include <memory>
 #include <algorithm>
@@ -18,7 +19,8 @@
 #include <QLibrary>
 #include <QList>
 #include <QDir>
-#include <QList>
+#include <QFileInfo>
+#include <QHash>
 #include <QIcon>
 
 #if defined(__APPLE__)
@@ -34,6 +36,43 @@
 extern "C" typedef void* (*OPENTRACK_CTOR_FUNPTR)(void);
 extern "C" typedef Metadata* (*OPENTRACK_METADATA_FUNPTR)(void);
 
+namespace plugin_api {
+namespace detail {
+
+// Module names and icons keyed by path, size and mtime. Lets us list modules
+// without dlopen'ing every one of them on startup. Written back on destruction.
+class OTR_API_EXPORT module_cache final
+{
+public:
+    struct entry
+    {
+        QString name;
+        QIcon icon;
+        qint64 size = -1, mtime = -1;
+    };
+
+    explicit module_cache(const QString& library_path);
+    ~module_cache();
+
+    const entry* find(const QFileInfo& file);
+    void insert(const QFileInfo& file, const QString& name, const QIcon& icon);
+
+    module_cache(const module_cache&) = delete;
+    module_cache& operator=(const module_cache&) = delete;
+
+private:
+    QHash<QString, entry> entries;
+    QHash<QString, entry> used;
+    QString pathname;
+    bool dirty = false;
+
+    void load();
+    void save();
+};
+
+} // ns detail
+} // ns plugin_api
+
 struct dylib final
 {
     enum Type : unsigned
@@ -57,19 +96,7 @@ struct dylib final
         if (filename_.size() == 0 || module_name.size() == 0)
             return;
 
-        handle.setFileName(filename_);
-        handle.setLoadHints(QLibrary::DeepBindHint | QLibrary::PreventUnloadHint);
-
-        if (check(!handle.load()))
-            return;
-
-        if (check((Dialog = (OPENTRACK_CTOR_FUNPTR) handle.resolve("GetDialog"), !Dialog)))
-            return;
-
-        if (check((Constructor = (OPENTRACK_CTOR_FUNPTR) handle.resolve("GetConstructor"), !Constructor)))
-            return;
-
-        if (check((Meta = (OPENTRACK_METADATA_FUNPTR) handle.resolve("GetMetadata"), !Meta)))
+        if (!load())
             return;
 
         auto m = std::unique_ptr<Metadata>(Meta());
@@ -79,15 +106,59 @@ struct dylib final
 
         type = t;
     }
+
+    // metadata came from the module cache, the library gets loaded on first use
+    dylib(const QString& filename_, Type t, const QString& name_, const QIcon& icon_) :
+        type(t),
+        full_filename(filename_),
+        module_name(trim_filename(filename_)),
+        icon(icon_),
+        name(name_),
+        Dialog(nullptr),
+        Constructor(nullptr),
+        Meta(nullptr)
+    {
+        if (filename_.size() == 0 || module_name.size() == 0)
+            type = Invalid;
+    }
+
     ~dylib()
     {
         // QLibrary refcounts the .dll's so don't forcefully unload
     }
 
+    // resolve the entry points, loading the library if it isn't already
+    bool load()
+    {
+        if (Constructor)
+            return true;
+
+        if (full_filename.size() == 0 || module_name.size() == 0)
+            return false;
+
+        handle.setFileName(full_filename);
+        handle.setLoadHints(QLibrary::DeepBindHint | QLibrary::PreventUnloadHint);
+
+        if (check(!handle.load()))
+            return false;
+
+        if (check((Dialog = (OPENTRACK_CTOR_FUNPTR) handle.resolve("GetDialog"), !Dialog)))
+            return false;
+
+        if (check((Meta = (OPENTRACK_METADATA_FUNPTR) handle.resolve("GetMetadata"), !Meta)))
+            return false;
+
+        if (check((Constructor = (OPENTRACK_CTOR_FUNPTR) handle.resolve("GetConstructor"), !Constructor)))
+            return false;
+
+        return true;
+    }
+
     static QList<std::shared_ptr<dylib>> enum_libraries(const QString& library_path)
     {
         QDir module_directory(library_path);
         QList<std::shared_ptr<dylib>> ret;
+        plugin_api::detail::module_cache cache(library_path);
 
         using str = QLatin1String;
 
@@ -103,9 +174,21 @@ struct dylib final
 
         for (const filter_& filter : filters)
         {
-            for (const QString& filename : module_directory.entryList({ filter.glob }, QDir::Files, QDir::Name))
+            for (const QFileInfo& file : module_directory.entryInfoList({ filter.glob }, QDir::Files, QDir::Name))
             {
-                std::shared_ptr<dylib> lib = std::make_shared<dylib>(QStringLiteral("%1/%2").arg(library_path).arg(filename), filter.type);
+                const QString filename = file.fileName();
+                const QString pathname = QStringLiteral("%1/%2").arg(library_path).arg(filename);
+                std::shared_ptr<dylib> lib;
+
+                if (auto* entry = cache.find(file))
+                    lib = std::make_shared<dylib>(pathname, filter.type, entry->name, entry->icon);
+                else
+                {
+                    lib = std::make_shared<dylib>(pathname, filter.type);
+
+                    if (lib->type != Invalid)
+                        cache.insert(file, lib->name, lib->icon);
+                }
 
                 if (lib->type == Invalid)
                     continue;
@@ -241,7 +324,7 @@ template<typename t>
 static inline std::shared_ptr<t> make_dylib_instance(const std::shared_ptr<dylib>& lib)
 {
     std::shared_ptr<t> ret;
-    if (lib != nullptr && lib->Constructor)
+    if (lib != nullptr && lib->load())
         ret = std::shared_ptr<t>(reinterpret_cast<t*>(reinterpret_cast<OPENTRACK_CTOR_FUNPTR>(lib->Constructor)()));
     return ret;
 }
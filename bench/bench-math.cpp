@@ -0,0 +1,167 @@
+#include "suites.hpp"
+
+#include "compat/euler.hpp"
+#include "compat/quat.hpp"
+#include "compat/math-imports.hpp"
+#include "spline/spline.hpp"
+#include "options/options.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace options;
+
+template<int h, int w>
+static double max_abs_diff(const Mat<double, h, w>& a, const Mat<double, h, w>& b)
+{
+    double ret = 0;
+    for (int j = 0; j < h; j++)
+        for (int i = 0; i < w; i++)
+            ret = std::max(ret, std::fabs(a(j, i) - b(j, i)));
+    return ret;
+}
+
+// the pipeline's quaternion path against the rotation matrices it replaced,
+// over a grid of angles that includes gimbal lock at +-90 degrees pitch
+static void check_quat(bench_runner& r)
+{
+    using namespace euler;
+
+    static const char* const name = "euler/quat-matches-rmat";
+    static constexpr double eps = 1e-9;
+
+    if (!r.enabled(name))
+        return;
+
+    double to_rmat = 0, round_trip = 0, angles = 0, rotate = 0;
+    const dvec3 v(.3, -.5, .8);
+
+    for (int k = -8; k <= 8; k++)
+        for (int j = -8; j <= 8; j++)
+            for (int i = -8; i <= 8; i++)
+            {
+                const euler_t x(k * M_PI/8, j * M_PI/16, i * M_PI/8);
+                const rmat R = euler_to_rmat(x);
+                const quat q = euler_to_quat(x);
+
+                to_rmat = std::max(to_rmat, max_abs_diff(quat_to_rmat(q), R));
+                rotate = std::max(rotate, max_abs_diff(q.rotate(v), dvec3(R * v)));
+
+                // at gimbal lock and at +-180 degrees the angles aren't unique,
+                // so compare the rotations they stand for
+                const euler_t y = quat_to_euler(q);
+                round_trip = std::max(round_trip, max_abs_diff(euler_to_rmat(y), R));
+
+                if (std::abs(j) < 8 && std::abs(k) < 8 && std::abs(i) < 8)
+                    angles = std::max(angles, max_abs_diff(y, x));
+            }
+
+    const double worst = std::max({ to_rmat, round_trip, angles, rotate });
+
+    r.check(name, worst < eps,
+            QStringLiteral("max error: to rmat %1, round trip %2, angles %3, rotate %4")
+                .arg(to_rmat).arg(round_trip).arg(angles).arg(rotate));
+}
+
+void bench_math(bench_runner& r)
+{
+    check_quat(r);
+
+    {
+        // a typical curve, bundle not backed by a profile
+        spline sp;
+        for (QPointF p : { QPointF(0, 0), QPointF(10, 5), QPointF(30, 25),
+                           QPointF(60, 70), QPointF(120, 150), QPointF(180, 180) })
+            sp.add_point(p);
+
+        double x = 0;
+
+        r.run("spline/get-value", [&] {
+            float y = sp.get_value(x);
+            keep(y);
+            x = x < 180 ? x + .37 : 0;
+        });
+
+        r.run("spline/get-value-no-save", [&] {
+            float y = sp.get_value_no_save(x);
+            keep(y);
+            x = x < 180 ? x + .37 : 0;
+        }, 0);
+    }
+
+    {
+        euler::euler_t e(.3, -.2, .1);
+
+        r.run("euler/euler-to-rmat", [&] {
+            euler::rmat R = euler::euler_to_rmat(e);
+            keep(R);
+            e(0) = e(0) < M_PI ? e(0) + 1e-3 : -M_PI;
+        }, 0);
+
+        r.run("euler/euler-to-quat", [&] {
+            euler::quat q = euler::euler_to_quat(e);
+            keep(q);
+            e(0) = e(0) < M_PI ? e(0) + 1e-3 : -M_PI;
+        }, 0);
+
+        euler::rmat R = euler::euler_to_rmat(e);
+        euler::quat q = euler::euler_to_quat(e);
+
+        r.run("euler/rmat-to-euler", [&] {
+            euler::euler_t ret = euler::rmat_to_euler(R);
+            keep(ret);
+            keep(R);
+        }, 0);
+
+        r.run("euler/quat-to-euler", [&] {
+            euler::euler_t ret = euler::quat_to_euler(q);
+            keep(ret);
+            keep(q);
+        }, 0);
+
+        // what centering, reltrans and the neck offset do per tick
+        euler::dvec3 v(.3, -.5, .8);
+
+        r.run("euler/rotate-rmat", [&] {
+            euler::dvec3 ret = R * v;
+            keep(ret);
+            keep(v);
+        }, 0);
+
+        r.run("euler/rotate-quat", [&] {
+            euler::dvec3 ret = q.rotate(v);
+            keep(ret);
+            keep(v);
+        }, 0);
+
+        const euler::rmat R2 = euler::euler_to_rmat({ -.1, .4, .2 });
+        const euler::quat q2 = euler::euler_to_quat({ -.1, .4, .2 });
+
+        r.run("euler/compose-rmat", [&] {
+            euler::rmat ret = R * R2;
+            keep(ret);
+            keep(R);
+        }, 0);
+
+        r.run("euler/compose-quat", [&] {
+            euler::quat ret = q * q2;
+            keep(ret);
+            keep(q);
+        }, 0);
+    }
+}
+
+void bench_options(bench_runner& r)
+{
+    bundle b = make_bundle(QString());
+
+    value<double> d(b, "double", 1.5);
+    value<int> i(b, "int", 3);
+    value<bool> f(b, "bool", true);
+    value<QString> s(b, "string", "foo");
+
+    r.run("options/value-double", [&] { double x = d(); keep(x); });
+    r.run("options/value-int", [&] { int x = i(); keep(x); });
+    r.run("options/value-bool", [&] { bool x = f(); keep(x); });
+    r.run("options/value-qstring", [&] { QString x = s(); keep(x); });
+}
@@ -0,0 +1,90 @@
+#ifdef OTR_BENCH_HAVE_OPENCV
+
+#include "suites.hpp"
+
+#include <vector>
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+using buffer = std::vector<unsigned char>;
+
+static constexpr int frame_count = 16, w = 640, h = 480;
+
+// what a webcam sends in MJPEG mode: 4:2:0, fairly high quality
+static std::vector<buffer> make_stream()
+{
+    std::vector<buffer> ret(frame_count);
+    cv::RNG rng(0x3a9e1);
+    const std::vector<int> params { cv::IMWRITE_JPEG_QUALITY, 90 };
+
+    for (int k = 0; k < frame_count; k++)
+    {
+        cv::Mat3b mat(h, w);
+        rng.fill(mat, cv::RNG::NORMAL, cv::Scalar::all(24), cv::Scalar::all(8));
+        cv::GaussianBlur(mat, mat, cv::Size(0, 0), 3);
+
+        const cv::Point offset(3 * k, 2 * k);
+        for (cv::Point p : { cv::Point(300, 180), cv::Point(290, 260), cv::Point(340, 300) })
+            cv::circle(mat, p + offset, 5, cv::Scalar::all(250), cv::FILLED, cv::LINE_AA);
+
+        cv::imencode(".jpg", mat, ret[k], params);
+    }
+
+    return ret;
+}
+
+static std::vector<buffer> load_stream(const QString& dir)
+{
+    std::vector<buffer> ret;
+
+    for (const QString& name : QDir(dir).entryList({ "*.jpg", "*.jpeg" }, QDir::Files, QDir::Name))
+    {
+        QFile f(QDir(dir).filePath(name));
+        if (!f.open(QFile::ReadOnly))
+            continue;
+        const QByteArray data = f.readAll();
+        ret.emplace_back(data.cbegin(), data.cend());
+    }
+
+    return ret;
+}
+
+void bench_mjpeg(bench_runner& r, const QString& jpeg_dir)
+{
+    if (!r.any_enabled({ "mjpeg/bgr-to-gray", "mjpeg/luma" }))
+        return;
+
+    const std::vector<buffer> stream = jpeg_dir.isEmpty() ? make_stream() : load_stream(jpeg_dir);
+
+    if (stream.empty())
+    {
+        qDebug() << "bench: no JPEG files in" << jpeg_dir;
+        return;
+    }
+
+    cv::Mat color, gray;
+    unsigned k = 0;
+
+    // what the trackers did before: the backend decodes color, then
+    // the tracker throws it away.
+    r.run("mjpeg/bgr-to-gray", [&] {
+        color = cv::imdecode(stream[k], cv::IMREAD_COLOR);
+        cv::cvtColor(color, gray, cv::COLOR_BGR2GRAY);
+        keep(gray.data);
+        k = (k + 1) % stream.size();
+    });
+
+    r.run("mjpeg/luma", [&] {
+        gray = cv::imdecode(stream[k], cv::IMREAD_GRAYSCALE);
+        keep(gray.data);
+        k = (k + 1) % stream.size();
+    });
+}
+
+#endif
@@ -0,0 +1,204 @@
+#include "suites.hpp"
+
+#include "api/plugin-support.hpp"
+#include "logic/pipeline.hpp"
+#include "logic/main-settings.hpp"
+#include "logic/mappings.hpp"
+#include "logic/extensions.hpp"
+#include "logic/tracklogger.hpp"
+#include "compat/sleep.hpp"
+#include "options/scoped.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include <QDebug>
+#include <QTemporaryDir>
+
+// an empty profile, for settings that filters and the pipeline make on
+// their own. nothing saves to it, so they always have their defaults.
+static const QString& defaults_profile()
+{
+    static QTemporaryDir dir;
+    static const QString ret = dir.filePath("defaults.ini");
+    return ret;
+}
+
+test_generator make_generator(const bench_source& src)
+{
+    options::with_profile defaults(defaults_profile());
+
+    test_settings s;
+    s.waveform = src.waveform;
+    s.replay_file = src.replay_file;
+
+    return test_generator(s);
+}
+
+void bench_filters(bench_runner& r, const QString& library_path, const bench_source& src)
+{
+    Modules modules(library_path);
+    options::with_profile defaults(defaults_profile());
+
+    for (const std::shared_ptr<dylib>& lib : modules.filters())
+    {
+        const QString name = "filter/" + lib->module_name;
+
+        if (!r.enabled(name))
+            continue;
+
+        if (!lib->load())
+        {
+            qDebug() << "bench: can't load" << lib->full_filename;
+            continue;
+        }
+
+        std::unique_ptr<IFilter> f(reinterpret_cast<IFilter*>(lib->Constructor()));
+        const module_status status = f->initialize();
+
+        if (!status.is_ok())
+        {
+            qDebug() << "bench: filter" << lib->name << "failed:" << status.error;
+            continue;
+        }
+
+        test_generator gen = make_generator(src);
+        double t = 0, out[6];
+
+        r.run(name, [&] {
+            const test_sample x = gen.next(t);
+            f->filter(x.pose, out);
+            keep(out);
+            t += 1./250;
+        });
+    }
+}
+
+namespace {
+
+// the test tracker's samples, one per pipeline tick
+struct bench_tracker final : ITracker
+{
+    Timer& clock;
+    test_generator gen;
+    double t = 0;
+
+    bench_tracker(Timer& clock, test_generator gen) : clock(clock), gen(std::move(gen)) {}
+    module_status start_tracker(QFrame*) override { return status_ok(); }
+
+    void data(double* ret) override
+    {
+        clock.start();
+        const test_sample x = gen.next(t);
+        std::copy(x.pose, x.pose + 6, ret);
+        t += 1./250;
+    }
+};
+
+// times each tick from the tracker's data() to the pose reaching here
+struct bench_protocol final : IProtocol
+{
+    Timer& clock;
+    std::vector<double> samples;
+    std::atomic<unsigned> count { 0 };
+
+    bench_protocol(Timer& clock, unsigned ticks) : clock(clock), samples(ticks) {}
+    module_status initialize() override { return status_ok(); }
+    QString game_name() override { return "bench"; }
+
+    void pose(const double*) override
+    {
+        const unsigned k = count.load(std::memory_order_relaxed);
+        if (k < samples.size())
+        {
+            samples[k] = clock.elapsed_nsecs();
+            count.store(k + 1, std::memory_order_release);
+        }
+    }
+};
+
+} // ns
+
+void bench_pipeline(bench_runner& r, int ticks, const bench_source& src)
+{
+    static const char* const name = "pipeline/logic";
+
+    if (!r.enabled(name) || ticks <= 0)
+        return;
+
+    // centering, reltrans, neck and mappings at their defaults
+    options::with_profile defaults(defaults_profile());
+
+    main_settings s;
+    Mappings mappings(s.all_axis_opts);
+    const Modules::dylib_list no_extensions;
+    event_handler ev(no_extensions);
+    TrackLogger logger;
+    Timer clock;
+
+    auto tracker = std::make_shared<bench_tracker>(clock, make_generator(src));
+    auto proto = std::make_shared<bench_protocol>(clock, ticks);
+
+    runtime_libraries libs;
+    libs.pTracker = tracker;
+    libs.pProtocol = proto;
+    libs.correct = true;
+
+    double allocations = -1;
+
+    {
+        pipeline p(mappings, libs, ev, logger);
+        p.start();
+
+        while (proto->count.load(std::memory_order_acquire) < unsigned(ticks))
+            portable::sleep(50);
+
+        // before the pipeline thread goes away
+        if (thread_monitor::counts_allocations())
+            for (const thread_monitor::usage& x : thread_monitor::sample())
+                if (x.name == "pipeline" && x.ticks)
+                    allocations = x.allocations / double(x.ticks);
+    }
+
+    r.add(name, proto->samples, allocations);
+}
+
+void bench_protocols(bench_runner& r, const QString& library_path, const bench_source& src)
+{
+    Modules modules(library_path);
+    options::with_profile defaults(defaults_profile());
+
+    for (const std::shared_ptr<dylib>& lib : modules.protocols())
+    {
+        const QString name = "protocol/" + lib->module_name;
+
+        if (!r.enabled(name))
+            continue;
+
+        if (!lib->load())
+        {
+            qDebug() << "bench: can't load" << lib->full_filename;
+            continue;
+        }
+
+        std::unique_ptr<IProtocol> p(reinterpret_cast<IProtocol*>(lib->Constructor()));
+        const module_status status = p->initialize();
+
+        // most need a game, a driver or a device to talk to
+        if (!status.is_ok())
+        {
+            qDebug() << "bench: protocol" << lib->name << "skipped:" << status.error;
+            continue;
+        }
+
+        test_generator gen = make_generator(src);
+        double t = 0;
+
+        r.run(name, [&] {
+            const test_sample x = gen.next(t);
+            p->pose(x.pose);
+            t += 1./250;
+        });
+    }
+}
@@ -0,0 +1,93 @@
+#ifdef OTR_BENCH_HAVE_PT
+
+#include "suites.hpp"
+
+#include "tracker-pt/point_tracker.h"
+#include "tracker-pt/module/point_extractor.h"
+#include "tracker-pt/module/frame.hpp"
+
+#include <vector>
+
+#include <QDebug>
+
+#include <opencv2/imgproc.hpp>
+
+using namespace pt_module;
+
+// not in any profile, so always the defaults
+static const QString settings_name = "tracker-pt-bench";
+
+static constexpr int frame_count = 16, w = 640, h = 480;
+
+// three IR points drifting over a noisy background, like a clip model
+static std::vector<Frame> make_frames()
+{
+    std::vector<Frame> ret(frame_count);
+    cv::RNG rng(0xbe9c4);
+
+    for (int k = 0; k < frame_count; k++)
+    {
+        cv::Mat3b mat(h, w);
+        rng.fill(mat, cv::RNG::NORMAL, cv::Scalar::all(24), cv::Scalar::all(8));
+
+        const cv::Point offset(3 * k, 2 * k);
+        for (cv::Point p : { cv::Point(300, 180), cv::Point(290, 260), cv::Point(340, 300) })
+            cv::circle(mat, p + offset, 5, cv::Scalar::all(250), cv::FILLED, cv::LINE_AA);
+
+        ret[k].mat = mat;
+    }
+
+    return ret;
+}
+
+void bench_pt(bench_runner& r)
+{
+    if (!r.any_enabled({ "pt/extract-points", "pt/track" }))
+        return;
+
+    const std::vector<Frame> frames = make_frames();
+    PointExtractor extractor(settings_name);
+    Preview preview(w, h);
+    std::vector<vec2> points;
+
+    std::vector<std::vector<vec2>> all_points;
+    for (const Frame& f : frames)
+    {
+        extractor.extract_points(f, preview, points);
+        if (points.size() >= PointModel::N_POINTS)
+            all_points.push_back(points);
+    }
+
+    int k = 0;
+
+    r.run("pt/extract-points", [&] {
+        extractor.extract_points(frames[k], preview, points);
+        keep(points);
+        k = (k + 1) % frame_count;
+    });
+
+    if (all_points.empty())
+    {
+        qDebug() << "bench: no points found in the canned frames";
+        return;
+    }
+
+    pt_settings s(settings_name);
+    const PointModel model(s);
+    pt_camera_info info;
+    info.fov = s.fov;
+    info.res_x = w;
+    info.res_y = h;
+
+    PointTracker tracker;
+    unsigned i = 0;
+
+    r.run("pt/track", [&] {
+        tracker.track(all_points[i], model, info, s.init_phase_timeout);
+        Affine X_CM = tracker.pose();
+        keep(X_CM);
+        i = (i + 1) % all_points.size();
+    });
+}
+
+#endif
@@ -0,0 +1,162 @@
+// Micro-benchmarks for the per-frame code paths. Results go to stdout or
+// a file as JSON, so runs from different builds can be compared:
+//
+//   opentrack-bench --output 2.3.12.json
+//
+// Everything uses default settings, never the user's profile, so that runs
+// on different machines are comparable.
+//
+// Builds with opentrack_count-allocations also record allocations per
+// iteration, and exit with an error if a case meant not to allocate did.
+// Checks of optimized code against what it replaced, such as the pipeline's
+// quaternions against rotation matrices, fail the run the same way.
+//
+// Filters, the pipeline and protocols are fed the test tracker's motion,
+// sawtooth unless given another --waveform. Protocols that can't start
+// without a game or a device are skipped; the others really send, e.g. the
+// mouse protocol moves the pointer, so leave it out with --filter if need be.
+//
+// MJPEG decoding runs on synthetic frames unless given a directory of
+// frames recorded from a camera, for instance with
+//
+//   ffmpeg -f v4l2 -input_format mjpeg -i /dev/video0 -c copy -frames 300 %04d.jpg
+
+#include "suites.hpp"
+
+#include "options/options.hpp"
+#include "compat/library-path.hpp"
+
+#include <cstdlib>
+#include <cstdio>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QDebug>
+
+#if defined __x86_64__ || defined __SSE2__ || defined _M_AMD64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#   include <xmmintrin.h>
+#   include <pmmintrin.h>
+#   define OTR_HAS_DENORM_CONTROL
+#endif
+
+using namespace options;
+
+extern "C" const char* const opentrack_version;
+
+static const struct { const char* name; test_waveform value; } waveforms[] =
+{
+    { "sawtooth", test_sawtooth },
+    { "sine-sweep", test_sine_sweep },
+    { "steps", test_step },
+    { "noise", test_noise },
+    { "replay", test_replay },
+};
+
+static bool parse_waveform(const QString& name, test_waveform& ret)
+{
+    for (const auto& x : waveforms)
+        if (name == x.name)
+        {
+            ret = x.value;
+            return true;
+        }
+    return false;
+}
+
+static QString compiler_name()
+{
+#if defined __clang__
+    return QStringLiteral("clang " __clang_version__);
+#elif defined __GNUC__
+    return QStringLiteral("gcc " __VERSION__);
+#elif defined _MSC_VER
+    return QStringLiteral("msvc %1").arg(_MSC_FULL_VER);
+#else
+    return QStringLiteral("unknown");
+#endif
+}
+
+int main(int argc, char** argv)
+{
+#if defined OTR_HAS_DENORM_CONTROL
+    // same as the main executable, filters are sensitive to it
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+#endif
+
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    QCommandLineParser args;
+    args.setApplicationDescription("opentrack micro-benchmarks");
+    args.addHelpOption();
+    args.addOption({ { "o", "output" }, "Write JSON results here instead of stdout.", "file" });
+    args.addOption({ { "f", "filter" }, "Only run cases whose name contains this.", "text" });
+    args.addOption({ "batches", "Timed batches per case.", "n", "15" });
+    args.addOption({ "batch-ms", "Approximate length of a batch.", "ms", "20" });
+    args.addOption({ "pipeline-ticks", "Pipeline iterations to time, at 250 Hz.", "n", "1000" });
+    args.addOption({ "jpeg-dir", "Decode the JPEG files in this directory.", "dir" });
+    args.addOption({ "waveform", "Test tracker motion fed to filters, the pipeline and protocols: "
+                                 "sawtooth, sine-sweep, steps, noise or replay.", "name", "sawtooth" });
+    args.addOption({ "replay-file", "Pose log for the replay waveform.", "file" });
+    args.process(app);
+
+    bench_source src;
+    src.replay_file = args.value("replay-file");
+
+    if (!parse_waveform(args.value("waveform"), src.waveform))
+    {
+        qDebug() << "no such waveform" << args.value("waveform");
+        return EXIT_FAILURE;
+    }
+
+    if (src.waveform == test_replay && !make_generator(src).replay_loaded())
+    {
+        qDebug() << "can't load replay file" << src.replay_file;
+        return EXIT_FAILURE;
+    }
+
+    bench_runner r(args.value("filter"), args.value("batches").toInt(), args.value("batch-ms").toDouble());
+
+    bench_math(r);
+    bench_options(r);
+#ifdef OTR_BENCH_HAVE_PT
+    bench_pt(r);
+#endif
+#ifdef OTR_BENCH_HAVE_OPENCV
+    bench_mjpeg(r, args.value("jpeg-dir"));
+#endif
+    bench_filters(r, OPENTRACK_BASE_PATH + OPENTRACK_LIBRARY_PATH, src);
+    bench_pipeline(r, args.value("pipeline-ticks").toInt(), src);
+    bench_protocols(r, OPENTRACK_BASE_PATH + OPENTRACK_LIBRARY_PATH, src);
+
+    QJsonObject ret = r.to_json();
+    ret["version"] = opentrack_version;
+    ret["compiler"] = compiler_name();
+    ret["cpu"] = QSysInfo::currentCpuArchitecture();
+    ret["os"] = QSysInfo::prettyProductName();
+    ret["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    ret["waveform"] = args.value("waveform");
+
+    const QByteArray json = QJsonDocument(ret).toJson();
+
+    if (args.isSet("output"))
+    {
+        QFile f(args.value("output"));
+        if (!f.open(QFile::WriteOnly | QFile::Truncate) || f.write(json) != json.size())
+        {
+            qDebug() << "can't write" << f.fileName() << f.errorString();
+            return EXIT_FAILURE;
+        }
+    }
+    else
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+
+    return r.failed() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#include "runner.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <cstdio>
+
+#include <QJsonArray>
+
+bench_runner::bench_runner(const QString& filter, int batches, double batch_ms) :
+    filter(filter), batches(std::max(1, batches)), batch_ms(std::max(.1, batch_ms))
+{
+}
+
+bool bench_runner::enabled(const QString& name) const
+{
+    return filter.isEmpty() || name.contains(filter);
+}
+
+bool bench_runner::any_enabled(std::initializer_list<QString> names) const
+{
+    return std::any_of(names.begin(), names.end(), [this](const QString& x) { return enabled(x); });
+}
+
+void bench_runner::add(const QString& name, std::vector<double> samples, double allocations)
+{
+    result r;
+    r.name = name;
+    r.iterations = (long long)samples.size();
+    r.allocations = allocations;
+
+    if (!samples.empty())
+    {
+        std::sort(samples.begin(), samples.end());
+        const unsigned sz = samples.size();
+        r.min_ns = samples.front();
+        r.max_ns = samples.back();
+        r.median_ns = sz % 2 ? samples[sz/2] : (samples[sz/2 - 1] + samples[sz/2]) / 2;
+        r.mean_ns = std::accumulate(samples.begin(), samples.end(), 0.) / sz;
+    }
+
+    print(r);
+    results.push_back(std::move(r));
+}
+
+void bench_runner::print(const result& r) const
+{
+    if (r.allocations >= 0)
+        std::fprintf(stderr, "%-40s %12.1f ns  (min %.1f, max %.1f)  %.2f allocs\n",
+                     r.name.toUtf8().constData(), r.median_ns, r.min_ns, r.max_ns, r.allocations);
+    else
+        std::fprintf(stderr, "%-40s %12.1f ns  (min %.1f, max %.1f)\n",
+                     r.name.toUtf8().constData(), r.median_ns, r.min_ns, r.max_ns);
+}
+
+void bench_runner::check(const QString& name, bool ok, const QString& detail)
+{
+    std::fprintf(stderr, "%-40s %s  %s\n", name.toUtf8().constData(),
+                 ok ? "ok" : "FAILED", detail.toUtf8().constData());
+
+    if (!ok)
+        failed_checks.push_back(name);
+}
+
+bool bench_runner::failed() const
+{
+    return !failed_checks.isEmpty() ||
+           std::any_of(results.cbegin(), results.cend(), [](const result& r) { return r.failed; });
+}
+
+QJsonObject bench_runner::to_json() const
+{
+    QJsonArray ret;
+
+    for (const result& r : results)
+    {
+        QJsonObject o {
+            { "name", r.name },
+            { "iterations", double(r.iterations) },
+            { "min-ns", r.min_ns },
+            { "median-ns", r.median_ns },
+            { "mean-ns", r.mean_ns },
+            { "max-ns", r.max_ns },
+        };
+
+        if (r.allocations >= 0)
+            o["allocations"] = r.allocations;
+        if (r.failed)
+            o["failed"] = true;
+
+        ret.append(o);
+    }
+
+    QJsonObject o {
+        { "batches", batches },
+        { "batch-ms", batch_ms },
+        { "results", ret },
+    };
+
+    if (!failed_checks.isEmpty())
+        o["failed-checks"] = QJsonArray::fromStringList(failed_checks);
+
+    return o;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "compat/timer.hpp"
+#include "compat/thread-monitor.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+#if defined _MSC_VER
+#   include <intrin.h>
+#endif
+
+// Keeps the compiler from dropping a computation whose result is unused.
+template<typename t>
+static inline void keep(t& x)
+{
+#if defined __GNUC__
+    asm volatile("" : : "g"(&x) : "memory");
+#else
+    const void* volatile sink = &x;
+    (void)sink;
+    _ReadWriteBarrier();
+#endif
+}
+
+// Runs each case in batches, sized so one batch takes about `batch_ms'.
+// Reports per-iteration times over all batches, so one slow batch (a
+// context switch, a page fault) shows in the max but not the median.
+
+class bench_runner final
+{
+public:
+    struct result
+    {
+        QString name;
+        long long iterations = 0;
+        double min_ns = 0, median_ns = 0, mean_ns = 0, max_ns = 0;
+        // per iteration, negative if not counted
+        double allocations = -1;
+        bool failed = false;
+    };
+
+    // only cases whose name contains `filter' are run
+    bench_runner(const QString& filter, int batches, double batch_ms);
+
+    bool enabled(const QString& name) const;
+    // whether any of a suite's cases would run, to skip its setup
+    bool any_enabled(std::initializer_list<QString> names) const;
+
+    // `fn()' is one iteration. with `max_allocations' not negative, the
+    // case fails if an iteration allocates more than that on average.
+    // only checked in builds that count allocations.
+    template<typename F>
+    void run(const QString& name, F&& fn, double max_allocations = -1);
+
+    // for cases that time themselves, one sample per iteration
+    void add(const QString& name, std::vector<double> samples_ns, double allocations = -1);
+
+    // a correctness check that runs with the benchmarks. a failed check
+    // fails the run, as an over-allocating case does.
+    void check(const QString& name, bool ok, const QString& detail);
+
+    // whether any case allocated more than it was allowed, or a check failed
+    bool failed() const;
+
+    QJsonObject to_json() const;
+
+private:
+    QString filter;
+    int batches;
+    double batch_ms;
+    std::vector<result> results;
+    QStringList failed_checks;
+
+    void print(const result& r) const;
+};
+
+template<typename F>
+void bench_runner::run(const QString& name, F&& fn, double max_allocations)
+{
+    if (!enabled(name))
+        return;
+
+    // warm up and find how many iterations fill a batch
+    long long n = 1;
+    for (;;)
+    {
+        Timer t;
+        for (long long i = 0; i < n; i++)
+            fn();
+        const double ms = t.elapsed_ms();
+        if (ms >= batch_ms / 4 || n >= (1ll << 40))
+        {
+            n = std::max(1ll, (long long)(n * batch_ms / std::max(ms, 1e-6)));
+            break;
+        }
+        n *= 4;
+    }
+
+    std::vector<double> samples;
+    samples.reserve(batches);
+
+    const unsigned long long allocs = thread_allocations();
+
+    for (int k = 0; k < batches; k++)
+    {
+        Timer t;
+        for (long long i = 0; i < n; i++)
+            fn();
+        samples.push_back(t.elapsed_nsecs() / double(n));
+    }
+
+    // reserve() keeps push_back() from allocating in the loop
+    const double per_iteration = thread_monitor::counts_allocations()
+                                 ? (thread_allocations() - allocs) / double(n * batches)
+                                 : -1;
+
+    add(name, std::move(samples), per_iteration);
+
+    result& r = results.back();
+    r.iterations = n * batches;
+
+    if (per_iteration >= 0 && max_allocations >= 0 && per_iteration > max_allocations)
+    {
+        r.failed = true;
+        std::fprintf(stderr, "%-40s allocates %.2f per iteration, allowed %.2f\n",
+                     name.toUtf8().constData(), per_iteration, max_allocations);
+    }
+}
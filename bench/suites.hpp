@@ -0,0 +1,30 @@
+#pragma once
+
+#include "runner.hpp"
+#include "tracker-test/generator.hpp"
+
+#include <QString>
+
+// what filters, the pipeline and protocols are fed, from the test tracker
+struct bench_source final
+{
+    test_waveform waveform = test_sawtooth;
+    QString replay_file;
+};
+
+// with default settings apart from `src'
+test_generator make_generator(const bench_source& src);
+
+void bench_math(bench_runner& r);
+void bench_options(bench_runner& r);
+void bench_filters(bench_runner& r, const QString& library_path, const bench_source& src);
+void bench_pipeline(bench_runner& r, int ticks, const bench_source& src);
+void bench_protocols(bench_runner& r, const QString& library_path, const bench_source& src);
+
+#ifdef OTR_BENCH_HAVE_PT
+void bench_pt(bench_runner& r);
+#endif
+
+#ifdef OTR_BENCH_HAVE_OPENCV
+void bench_mjpeg(bench_runner& r, const QString& jpeg_dir);
+#endif
@@ -11,22 +11,19 @@
 #ifdef __linux
 #   include <fcntl.h>
 #   include <sys/ioctl.h>
+#   include <sys/inotify.h>
 #   include <linux/videodev2.h>
 #   include <cerrno>
+#   include <cstring>
 #endif
 
-#include <QDebug>
+#include "timer.hpp"
 
-OTR_COMPAT_EXPORT int camera_name_to_index(const QString &name)
-{
-    auto list = get_camera_names();
-    int ret = list.indexOf(name);
-    if (ret < 0)
-        ret = 0;
-    return ret;
-}
+#include <QHash>
+#include <QMutex>
+#include <QDebug>
 
-OTR_COMPAT_EXPORT QList<QString> get_camera_names()
+static QList<QString> enumerate_cameras()
 {
     QList<QString> ret;
 #if defined(_WIN32)
@@ -109,3 +106,145 @@ OTR_COMPAT_EXPORT QList<QString> get_camera_names()
 #endif
     return ret;
 }
+
+namespace {
+
+// Enumerating can block for tens of ms per device, and the trackers look up
+// their camera by name on every settings change. Keep one list per process
+// and only enumerate again when /dev changes. Without inotify, the list
+// expires after a short while instead.
+
+struct camera_registry final
+{
+    camera_registry();
+    ~camera_registry();
+
+    QList<QString> names();
+    int index(const QString& name);
+
+    camera_registry(const camera_registry&) = delete;
+    camera_registry& operator=(const camera_registry&) = delete;
+
+private:
+    void maybe_refresh();
+    bool devices_changed();
+
+    static constexpr inline double max_age_ms = 2000;
+
+    QMutex mtx;
+    QList<QString> names_;
+    QHash<QString, int> indices;
+    Timer age;
+    bool stale = true;
+#ifdef __linux
+    int inotify_fd = -1;
+#endif
+};
+
+camera_registry::camera_registry()
+{
+#ifdef __linux
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd == -1)
+        qDebug() << "camera: inotify_init1" << std::strerror(errno);
+    else if (inotify_add_watch(inotify_fd, "/dev",
+                               IN_CREATE | IN_DELETE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO) == -1)
+    {
+        qDebug() << "camera: inotify_add_watch /dev" << std::strerror(errno);
+        close(inotify_fd);
+        inotify_fd = -1;
+    }
+#endif
+}
+
+camera_registry::~camera_registry()
+{
+#ifdef __linux
+    if (inotify_fd != -1)
+        close(inotify_fd);
+#endif
+}
+
+bool camera_registry::devices_changed()
+{
+#ifdef __linux
+    if (inotify_fd != -1)
+    {
+        // udev creates the node first and fixes its permissions after,
+        // hence IN_ATTRIB. the name is only readable with access.
+        alignas(inotify_event) char buf[4096];
+        bool ret = false;
+        ssize_t sz;
+
+        while ((sz = read(inotify_fd, buf, sizeof(buf))) > 0)
+        {
+            for (ssize_t pos = 0; pos < sz; )
+            {
+                const auto& ev = *reinterpret_cast<const inotify_event*>(buf + pos);
+                if (ev.mask & IN_Q_OVERFLOW)
+                    ret = true;
+                else if (ev.len > 0 && !std::strncmp(ev.name, "video", 5))
+                    ret = true;
+                pos += ssize_t(sizeof(inotify_event) + ev.len);
+            }
+        }
+
+        return ret;
+    }
+#endif
+    return age.elapsed_ms() > max_age_ms;
+}
+
+void camera_registry::maybe_refresh()
+{
+    if (devices_changed())
+        stale = true;
+
+    if (!stale)
+        return;
+
+    names_ = enumerate_cameras();
+    indices.clear();
+    indices.reserve(names_.size());
+    // same as QList::indexOf with duplicate names
+    for (int i = names_.size() - 1; i >= 0; i--)
+        indices.insert(names_[i], i);
+
+    stale = false;
+    age.start();
+}
+
+QList<QString> camera_registry::names()
+{
+    QMutexLocker l(&mtx);
+    maybe_refresh();
+    return names_;
+}
+
+int camera_registry::index(const QString& name)
+{
+    QMutexLocker l(&mtx);
+    maybe_refresh();
+    return indices.value(name, -1);
+}
+
+camera_registry& get_registry()
+{
+    static camera_registry ret;
+    return ret;
+}
+
+} // ns
+
+OTR_COMPAT_EXPORT QList<QString> get_camera_names()
+{
+    return get_registry().names();
+}
+
+OTR_COMPAT_EXPORT int camera_name_to_index(const QString &name)
+{
+    int ret = get_registry().index(name);
+    if (ret < 0)
+        ret = 0;
+    return ret;
+}
@@ -13,6 +13,7 @@
 
 #include "export.hpp"
 
+// both are cached per process, and cheap to call repeatedly
 OTR_COMPAT_EXPORT QList<QString> get_camera_names();
 OTR_COMPAT_EXPORT int camera_name_to_index(const QString &name);
 
@@ -8,7 +8,8 @@
 #pragma once
 
 #include <QDebug>
-#include <QStringList>
+#include <QString>
+#include <QSet>
 
 #if defined _WIN32
 
@@ -16,9 +17,9 @@
 #include <tlhelp32.h>
 
 template<typename = void>
-static QStringList get_all_executable_names()
+static QSet<QString> get_all_executable_names()
 {
-    QStringList ret;
+    QSet<QString> ret;
     HANDLE h = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     if (h == INVALID_HANDLE_VALUE)
         return ret;
@@ -33,7 +34,7 @@ static QStringList get_all_executable_names()
     }
 
     do {
-        ret.append(e.szExeFile);
+        ret.insert(e.szExeFile);
     } while (Process32Next(h, &e) == TRUE);
 
     CloseHandle(h);
@@ -50,9 +51,9 @@ static QStringList get_all_executable_names()
 #include <vector>
 
 template<typename = void>
-static QStringList get_all_executable_names()
+static QSet<QString> get_all_executable_names()
 {
-    QStringList ret;
+    QSet<QString> ret;
     std::vector<int> vec;
 
     while (true)
@@ -110,18 +111,18 @@ static QStringList get_all_executable_names()
                                 idx = cmdline[1].lastIndexOf('\\');
                             if (idx != -1)
                             {
-                                ret.append(cmdline[1].mid(idx+1));
+                                ret.insert(cmdline[1].mid(idx+1));
                             }
                             else
-                                ret.append(cmdline[1]);
+                                ret.insert(cmdline[1]);
                         }
                         else
                         {
-                            ret.append(tmp);
+                            ret.insert(tmp);
                         }
                     }
                     else
-                        ret.append(cmdline[0]);
+                        ret.insert(cmdline[0]);
                 }
             }
             return ret;
@@ -131,39 +132,177 @@ static QStringList get_all_executable_names()
 
 #elif defined __linux
 
-#include <proc/readproc.h>
 #include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace process_list_detail {
+
+struct proc_entry
+{
+    QString name;
+    // tells a reused PID from the process that had it before
+    unsigned long long start_time = 0;
+    unsigned scans = 0;
+    bool seen = false;
+};
+
+// field 22 of /proc/<pid>/stat, in clock ticks since boot
+static unsigned long long read_start_time(const char* pid)
+{
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%s/stat", pid);
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return 0;
+
+    char buf[1024];
+    const ssize_t len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+
+    if (len <= 0)
+        return 0;
+
+    buf[len] = '\0';
+
+    // the command name in field 2 may contain spaces and parens
+    const char* p = std::strrchr(buf, ')');
+    if (!p)
+        return 0;
+
+    // fields 3 to 21 come before it
+    for (unsigned i = 0; i < 20; i++)
+    {
+        p = std::strchr(p + 1, ' ');
+        if (!p)
+            return 0;
+    }
+
+    return std::strtoull(p + 1, nullptr, 10);
+}
+
+static QString read_exe_name(const char* pid)
+{
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%s/cmdline", pid);
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return QString();
+
+    // only argv[0] is needed
+    char buf[4096];
+    const ssize_t len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+
+    if (len <= 0)
+        return QString();
+
+    buf[len] = '\0';
+
+    // note, wine sets argv[0] so no parsing like in OSX case
+    const char* name = buf;
+    for (const char* p = buf; *p; p++)
+        if (*p == '/' || *p == '\\')
+            name = p + 1;
+
+    return QString::fromLocal8Bit(name);
+}
+
+} // ns process_list_detail
+
+// Incremental: only processes not seen on previous calls get their cmdline
+// read. A PID whose start time changed is a new process. The result is shared and only rebuilt when processes come and go.
+// Not reentrant, call from one thread only.
 template<typename = void>
-static QStringList get_all_executable_names()
+static QSet<QString> get_all_executable_names()
 {
-    QStringList ret;
-    proc_t** procs = readproctab(PROC_FILLCOM);
-    if (procs == nullptr)
+    using namespace process_list_detail;
+
+    // a young process may still exec() into something else, e.g. wine
+    // starting the game, so keep re-reading its cmdline for a few scans
+    static constexpr unsigned max_scans = 3;
+
+    static std::unordered_map<int, proc_entry> procs;
+    static QSet<QString> ret;
+    bool dirty = false;
+
+    DIR* dir = opendir("/proc");
+    if (!dir)
     {
-        qDebug() << "readproctab" << errno;
+        qDebug() << "opendir /proc" << errno;
         return ret;
     }
-    for (int i = 0; procs[i]; i++)
+
+    while (const struct dirent* d = readdir(dir))
+    {
+        char* end = nullptr;
+        const long pid = std::strtol(d->d_name, &end, 10);
+
+        if (pid <= 0 || *end != '\0')
+            continue;
+
+        proc_entry& e = procs[int(pid)];
+        e.seen = true;
+
+        const unsigned long long start_time = read_start_time(d->d_name);
+        if (start_time != e.start_time)
+        {
+            e.start_time = start_time;
+            e.scans = 0;
+        }
+
+        if (e.scans < max_scans)
+        {
+            e.scans++;
+            QString name = read_exe_name(d->d_name);
+            if (name != e.name)
+            {
+                e.name = std::move(name);
+                dirty = true;
+            }
+        }
+    }
+
+    closedir(dir);
+
+    for (auto it = procs.begin(); it != procs.end(); )
     {
-        // note, wine sets argv[0] so no parsing like in OSX case
-        auto proc = procs[i];
-        if (proc->cmdline && proc->cmdline[0])
+        if (!it->second.seen)
         {
-            QString tmp(proc->cmdline[0]);
-            const int idx = std::max(tmp.lastIndexOf('\\'), tmp.lastIndexOf('/'));
-            tmp = tmp.mid(idx == -1 ? 0 : idx+1);
-            ret.append(tmp);
+            if (!it->second.name.isEmpty())
+                dirty = true;
+            it = procs.erase(it);
         }
-        freeproc(procs[i]);
+        else
+        {
+            it->second.seen = false;
+            it++;
+        }
+    }
+
+    if (dirty)
+    {
+        ret.clear();
+        for (const auto& x : procs)
+            if (!x.second.name.isEmpty())
+                ret.insert(x.second.name);
     }
-    free(procs);
+
     return ret;
 }
 
 #else
 template<typename = void>
-static QStringList get_all_executable_names()
+static QSet<QString> get_all_executable_names()
 {
-    return QStringList();
+    return QSet<QString>();
 }
 #endif
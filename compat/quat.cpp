@@ -0,0 +1,126 @@
+#include "quat.hpp"
+#include "math-imports.hpp"
+#include <cmath>
+
+namespace euler {
+
+quat OTR_COMPAT_EXPORT euler_to_quat(const euler_t& input)
+{
+    // euler_to_rmat() is Rz(-yaw) * Ry(-pitch) * Rx(-roll)
+    const double H = -input(0) * .5;
+    const double P = -input(1) * .5;
+    const double B = -input(2) * .5;
+
+    const double c1 = cos(H), s1 = sin(H);
+    const double c2 = cos(P), s2 = sin(P);
+    const double c3 = cos(B), s3 = sin(B);
+
+    return {
+        c1*c2*c3 + s1*s2*s3,
+        c1*c2*s3 - s1*s2*c3,
+        c1*s2*c3 + s1*c2*s3,
+        s1*c2*c3 - c1*s2*s3,
+    };
+}
+
+euler_t OTR_COMPAT_EXPORT quat_to_euler(const quat& q)
+{
+    // rmat_to_euler(), computing only the matrix elements it reads
+    const double w = q.w, x = q.x, y = q.y, z = q.z;
+
+    const double r20 = 2*(x*z - y*w);
+    const double r21 = 2*(y*z + x*w);
+    const double r22 = 1 - 2*(x*x + y*y);
+
+    const double cy = sqrt(r22*r22 + r21*r21);
+
+    if (cy > 1e-10)
+    {
+        const double r00 = 1 - 2*(y*y + z*z);
+        const double r10 = 2*(x*y + z*w);
+
+        return {
+            atan2(-r10, r00),
+            atan2(r20, cy),
+            atan2(-r21, r22)
+        };
+    }
+    else
+    {
+        const double r01 = 2*(x*y - z*w);
+        const double r11 = 1 - 2*(x*x + z*z);
+
+        return {
+            atan2(r01, r11),
+            atan2(r20, cy),
+            0
+        };
+    }
+}
+
+quat OTR_COMPAT_EXPORT rmat_to_quat(const rmat& R)
+{
+    const double tr = R(0, 0) + R(1, 1) + R(2, 2);
+
+    if (tr > 0)
+    {
+        const double s = .5 / sqrt(tr + 1);
+        return { .25 / s, (R(2, 1) - R(1, 2)) * s, (R(0, 2) - R(2, 0)) * s, (R(1, 0) - R(0, 1)) * s };
+    }
+    else if (R(0, 0) > R(1, 1) && R(0, 0) > R(2, 2))
+    {
+        const double s = 2 * sqrt(1 + R(0, 0) - R(1, 1) - R(2, 2));
+        return { (R(2, 1) - R(1, 2)) / s, .25 * s, (R(0, 1) + R(1, 0)) / s, (R(0, 2) + R(2, 0)) / s };
+    }
+    else if (R(1, 1) > R(2, 2))
+    {
+        const double s = 2 * sqrt(1 + R(1, 1) - R(0, 0) - R(2, 2));
+        return { (R(0, 2) - R(2, 0)) / s, (R(0, 1) + R(1, 0)) / s, .25 * s, (R(1, 2) + R(2, 1)) / s };
+    }
+    else
+    {
+        const double s = 2 * sqrt(1 + R(2, 2) - R(0, 0) - R(1, 1));
+        return { (R(1, 0) - R(0, 1)) / s, (R(0, 2) + R(2, 0)) / s, (R(1, 2) + R(2, 1)) / s, .25 * s };
+    }
+}
+
+rmat OTR_COMPAT_EXPORT quat_to_rmat(const quat& q)
+{
+    const double w = q.w, x = q.x, y = q.y, z = q.z;
+
+    return {
+        1 - 2*(y*y + z*z),  2*(x*y - z*w),      2*(x*z + y*w),
+        2*(x*y + z*w),      1 - 2*(x*x + z*z),  2*(y*z - x*w),
+        2*(x*z - y*w),      2*(y*z + x*w),      1 - 2*(x*x + y*y),
+    };
+}
+
+quat OTR_COMPAT_EXPORT slerp(const quat& a, quat b, double t)
+{
+    double d = a.w*b.w + a.x*b.x + a.y*b.y + a.z*b.z;
+
+    // take the short way around
+    if (d < 0)
+    {
+        d = -d;
+        b = { -b.w, -b.x, -b.y, -b.z };
+    }
+
+    double ka, kb;
+
+    if (d > 1 - 1e-6)
+    {
+        ka = 1 - t;
+        kb = t;
+    }
+    else
+    {
+        const double theta = acos(d), st = sin(theta);
+        ka = sin((1 - t) * theta) / st;
+        kb = sin(t * theta) / st;
+    }
+
+    return { ka*a.w + kb*b.w, ka*a.x + kb*b.x, ka*a.y + kb*b.y, ka*a.z + kb*b.z };
+}
+
+} // end ns euler
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "export.hpp"
+#include "euler.hpp"
+
+namespace euler {
+
+// unit quaternion in the same frame as euler_to_rmat() and
+// rmat_to_euler(); quat_to_rmat(euler_to_quat(x)) == euler_to_rmat(x).
+struct quat final
+{
+    double w = 1, x = 0, y = 0, z = 0;
+
+    quat conj() const { return { w, -x, -y, -z }; }
+
+    // same as multiplying the rotation matrices
+    quat operator*(const quat& q) const
+    {
+        return {
+            w*q.w - x*q.x - y*q.y - z*q.z,
+            w*q.x + x*q.w + y*q.z - z*q.y,
+            w*q.y - x*q.z + y*q.w + z*q.x,
+            w*q.z + x*q.y - y*q.x + z*q.w,
+        };
+    }
+
+    // same as quat_to_rmat(*this) * v
+    dvec3 rotate(const dvec3& v) const
+    {
+        // v + 2w(u x v) + 2u x (u x v)
+        const double tx = 2 * (y*v(2) - z*v(1));
+        const double ty = 2 * (z*v(0) - x*v(2));
+        const double tz = 2 * (x*v(1) - y*v(0));
+
+        return {
+            v(0) + w*tx + y*tz - z*ty,
+            v(1) + w*ty + z*tx - x*tz,
+            v(2) + w*tz + x*ty - y*tx,
+        };
+    }
+};
+
+quat OTR_COMPAT_EXPORT euler_to_quat(const euler_t& input);
+euler_t OTR_COMPAT_EXPORT quat_to_euler(const quat& q);
+
+quat OTR_COMPAT_EXPORT rmat_to_quat(const rmat& R);
+rmat OTR_COMPAT_EXPORT quat_to_rmat(const quat& q);
+
+quat OTR_COMPAT_EXPORT slerp(const quat& a, quat b, double t);
+
+} // end ns euler
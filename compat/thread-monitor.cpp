@@ -0,0 +1,267 @@
+#include "thread-monitor.hpp"
+#include "timer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QJsonObject>
+
+#if defined _WIN32
+#   include <windows.h>
+#elif defined __APPLE__
+#   include <mach/mach.h>
+#   include <pthread.h>
+#else
+#   include <pthread.h>
+#   include <ctime>
+#endif
+
+// only ever written by its own thread, read by sample()
+static thread_local std::atomic<unsigned long long> allocations { 0 };
+
+#if defined OTR_COUNT_ALLOCATIONS && !defined _WIN32
+
+static void* counted_alloc(std::size_t size)
+{
+    allocations.store(allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    for (;;)
+    {
+        if (void* ret = std::malloc(size ? size : 1))
+            return ret;
+
+        std::new_handler fn = std::get_new_handler();
+        if (!fn)
+            throw std::bad_alloc();
+        fn();
+    }
+}
+
+static void* counted_alloc(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return counted_alloc(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t& x) noexcept { return counted_alloc(size, x); }
+void* operator new[](std::size_t size, const std::nothrow_t& x) noexcept { return counted_alloc(size, x); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+bool thread_monitor::counts_allocations() { return true; }
+
+#else
+
+bool thread_monitor::counts_allocations() { return false; }
+
+#endif
+
+unsigned long long thread_allocations()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+struct thread_monitor::entry final
+{
+    QString name;
+
+#if defined _WIN32
+    HANDLE thread = nullptr;
+#elif defined __APPLE__
+    mach_port_t thread = MACH_PORT_NULL;
+#else
+    clockid_t clock {};
+    bool have_clock = false;
+#endif
+
+    // that thread's counter, alive for as long as the entry
+    const std::atomic<unsigned long long>* allocs;
+    unsigned long long first_allocs, last_tick_allocs;
+
+    unsigned long long id;
+    double first_cpu_ms = 0;
+    Timer since_start;
+
+    std::atomic<unsigned long long> ticks { 0 }, allocating_ticks { 0 }, max_tick_allocations { 0 };
+
+    double cpu_ms() const;
+};
+
+double thread_monitor::entry::cpu_ms() const
+{
+#if defined _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!thread || !GetThreadTimes(thread, &created, &exited, &kernel, &user))
+        return 0;
+    const auto to_100ns = [](const FILETIME& x) {
+        return (unsigned long long)x.dwHighDateTime << 32 | x.dwLowDateTime;
+    };
+    return (to_100ns(kernel) + to_100ns(user)) * 1e-4;
+#elif defined __APPLE__
+    thread_basic_info_data_t info;
+    mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+    if (thread_info(thread, THREAD_BASIC_INFO, (thread_info_t)&info, &count) != KERN_SUCCESS)
+        return 0;
+    return (info.user_time.seconds + info.system_time.seconds) * 1e3 +
+           (info.user_time.microseconds + info.system_time.microseconds) * 1e-3;
+#else
+    timespec ts {};
+    if (!have_clock || clock_gettime(clock, &ts))
+        return 0;
+    return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+#endif
+}
+
+namespace {
+
+struct registry final
+{
+    QMutex mtx;
+    std::vector<thread_monitor::entry*> entries;
+    unsigned long long next_id = 1;
+};
+
+registry& get_registry()
+{
+    static registry ret;
+    return ret;
+}
+
+} // ns
+
+thread_monitor::thread_monitor(const QString& name) : e(new entry)
+{
+    e->name = name;
+
+#if defined _WIN32
+    if (!DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &e->thread,
+                         THREAD_QUERY_LIMITED_INFORMATION, FALSE, 0))
+        e->thread = nullptr;
+#elif defined __APPLE__
+    e->thread = pthread_mach_thread_np(pthread_self());
+#else
+    e->have_clock = !pthread_getcpuclockid(pthread_self(), &e->clock);
+#endif
+
+    e->allocs = &allocations;
+    e->first_allocs = e->last_tick_allocs = thread_allocations();
+    e->first_cpu_ms = e->cpu_ms();
+    e->since_start.start();
+
+    registry& r = get_registry();
+    QMutexLocker l(&r.mtx);
+    e->id = r.next_id++;
+    r.entries.push_back(e);
+}
+
+thread_monitor::~thread_monitor()
+{
+    {
+        registry& r = get_registry();
+        QMutexLocker l(&r.mtx);
+        r.entries.erase(std::remove(r.entries.begin(), r.entries.end(), e), r.entries.end());
+    }
+
+#if defined _WIN32
+    if (e->thread)
+        CloseHandle(e->thread);
+#endif
+
+    delete e;
+}
+
+void thread_monitor::tick()
+{
+    const unsigned long long n = thread_allocations();
+    const unsigned long long k = n - e->last_tick_allocs;
+    e->last_tick_allocs = n;
+
+    e->ticks.store(e->ticks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (k)
+    {
+        e->allocating_ticks.store(e->allocating_ticks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (k > e->max_tick_allocations.load(std::memory_order_relaxed))
+            e->max_tick_allocations.store(k, std::memory_order_relaxed);
+    }
+}
+
+std::vector<thread_monitor::usage> thread_monitor::sample(const std::vector<usage>& since)
+{
+    registry& r = get_registry();
+    QMutexLocker l(&r.mtx);
+
+    std::vector<usage> ret;
+    ret.reserve(r.entries.size());
+
+    for (const entry* x : r.entries)
+    {
+        usage u;
+        u.name = x->name;
+        u.id = x->id;
+        u.cpu_ms = x->cpu_ms() - x->first_cpu_ms;
+        u.wall_ms = x->since_start.elapsed_ms();
+        u.ticks = x->ticks.load(std::memory_order_relaxed);
+        u.allocations = x->allocs->load(std::memory_order_relaxed) - x->first_allocs;
+        u.allocating_ticks = x->allocating_ticks.load(std::memory_order_relaxed);
+        u.max_tick_allocations = x->max_tick_allocations.load(std::memory_order_relaxed);
+
+        double cpu = u.cpu_ms, wall = u.wall_ms;
+
+        for (const usage& p : since)
+            if (p.id == u.id)
+            {
+                cpu -= p.cpu_ms;
+                wall -= p.wall_ms;
+                break;
+            }
+
+        u.load = wall > 0 ? std::clamp(cpu / wall, 0., 1.) : 0;
+
+        ret.push_back(u);
+    }
+
+    return ret;
+}
+
+QJsonArray thread_monitor::to_json(const std::vector<usage>& xs)
+{
+    const bool allocs = counts_allocations();
+    QJsonArray ret;
+
+    for (const usage& x : xs)
+    {
+        QJsonObject o {
+            { "name", x.name },
+            { "cpu-ms", x.cpu_ms },
+            { "wall-ms", x.wall_ms },
+            { "load", x.load },
+            { "ticks", double(x.ticks) },
+        };
+
+        if (allocs)
+        {
+            o["allocations"] = double(x.allocations);
+            o["allocating-ticks"] = double(x.allocating_ticks);
+            o["max-tick-allocations"] = double(x.max_tick_allocations);
+        }
+
+        ret.append(o);
+    }
+
+    return ret;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "export.hpp"
+
+#include <vector>
+
+#include <QString>
+#include <QJsonArray>
+
+// CPU time and heap allocations of opentrack's own threads. A thread is
+// watched while it has a thread_monitor on its stack. It calls tick() once
+// per unit of work, such as a pipeline tick or a camera frame, so that
+// allocations can be told per unit.
+//
+// Allocations are only counted in builds with opentrack_count-allocations,
+// which is the default for debug builds. Windows builds don't count them,
+// since replacing operator new in a DLL only affects that DLL.
+
+class OTR_COMPAT_EXPORT thread_monitor final
+{
+public:
+    struct entry;
+
+private:
+    entry* e;
+
+public:
+    struct usage final
+    {
+        QString name;
+        // tells apart threads with the same name
+        unsigned long long id = 0;
+        // since the thread_monitor was made
+        double cpu_ms = 0, wall_ms = 0;
+        // share of one core since the `since' snapshot given to sample(),
+        // or since the thread_monitor was made
+        double load = 0;
+        unsigned long long ticks = 0, allocations = 0;
+        // ticks that allocated anything, and the most allocations in one
+        unsigned long long allocating_ticks = 0, max_tick_allocations = 0;
+    };
+
+    explicit thread_monitor(const QString& name);
+    ~thread_monitor();
+
+    void tick();
+
+    // pass the caller's own previous result, so that callers sampling at
+    // different times don't skew each other's load
+    static std::vector<usage> sample(const std::vector<usage>& since = {});
+    static QJsonArray to_json(const std::vector<usage>& xs);
+    static bool counts_allocations();
+
+    thread_monitor(const thread_monitor&) = delete;
+    thread_monitor& operator=(const thread_monitor&) = delete;
+};
+
+// heap allocations made by the calling thread so far. always 0 unless
+// thread_monitor::counts_allocations().
+OTR_COMPAT_EXPORT unsigned long long thread_allocations();
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+# Virtual keyboard on /dev/uinput, for testing the direct input device
+# shortcuts. Taps (or holds) one key at an interval. Opentrack times each
+# binding from the kernel's event timestamp to the binding having run, and
+# logs the min/median/max on exit.
+#
+# Bind the key in the options dialog, enable "Read input devices directly",
+# and either leave the device list empty or put the path this prints there.
+# Needs write access to /dev/uinput.
+#
+# With --check, starts opentrack-headless itself once the device is there,
+# presses the key --count times (default 10), stops it and reads back the
+# latency it wrote. Fails if no press was measured or one took longer than
+# --max-ms. The profile needs the key bound as above.
+#
+# usage: evdev-stand-in.py [--key F12] [--ctrl] [--shift] [--alt]
+#                          [--interval 1] [--hold 0.2] [--count 0]
+#                          [--check path/to/opentrack-headless [--profile name]
+#                           [--max-ms 10]]
+
+import argparse
+import fcntl
+import glob
+import json
+import os
+import signal
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+UI_SET_EVBIT = 0x40045564
+UI_SET_KEYBIT = 0x40045565
+UI_DEV_CREATE = 0x5501
+UI_DEV_DESTROY = 0x5502
+
+EV_SYN, EV_KEY = 0, 1
+SYN_REPORT = 0
+
+KEY_LEFTCTRL, KEY_LEFTSHIFT, KEY_LEFTALT = 29, 42, 56
+
+# a subset of <linux/input-event-codes.h>
+KEYS = {
+    "ESC": 1, "TAB": 15, "SPACE": 57, "ENTER": 28, "BACKSPACE": 14,
+    "INSERT": 110, "DELETE": 111, "HOME": 102, "END": 107,
+    "PAGEUP": 104, "PAGEDOWN": 109, "PAUSE": 119, "SCROLLLOCK": 70,
+    "LEFT": 105, "RIGHT": 106, "UP": 103, "DOWN": 108,
+    "KP0": 82, "KP1": 79, "KP2": 80, "KP3": 81, "KP4": 75,
+    "KP5": 76, "KP6": 77, "KP7": 71, "KP8": 72, "KP9": 73,
+}
+KEYS.update({"F%d" % i: 58 + i for i in range(1, 11)})
+KEYS.update({"F11": 87, "F12": 88})
+KEYS.update({str(i): 1 + i for i in range(1, 10)})
+KEYS["0"] = 11
+KEYS.update(zip("QWERTYUIOP", range(16, 26)))
+KEYS.update(zip("ASDFGHJKL", range(30, 39)))
+KEYS.update(zip("ZXCVBNM", range(44, 51)))
+
+NAME = b"opentrack evdev stand-in"
+
+
+def emit(fd, type_, code, value):
+    # struct input_event, the kernel fills in the timestamp
+    os.write(fd, struct.pack("llHHi", 0, 0, type_, code, value))
+
+
+def main():
+    p = argparse.ArgumentParser()
+    p.add_argument("--key", default="F12", help="one of: " + " ".join(sorted(KEYS)))
+    p.add_argument("--ctrl", action="store_true")
+    p.add_argument("--shift", action="store_true")
+    p.add_argument("--alt", action="store_true")
+    p.add_argument("--interval", type=float, default=1, help="seconds between presses")
+    p.add_argument("--hold", type=float, default=.2, help="seconds the key stays down")
+    p.add_argument("--count", type=int, default=0, help="presses, 0 for no limit")
+    p.add_argument("--check", metavar="HEADLESS", help="run opentrack-headless and check its latency")
+    p.add_argument("--profile", help="profile for --check")
+    p.add_argument("--max-ms", type=float, default=10, help="slowest press --check allows")
+    args = p.parse_args()
+
+    if args.check and not args.count:
+        args.count = 10
+
+    key = KEYS.get(args.key.upper())
+    if key is None:
+        sys.exit("unknown key " + args.key)
+
+    mods = [code for flag, code in ((args.ctrl, KEY_LEFTCTRL),
+                                    (args.shift, KEY_LEFTSHIFT),
+                                    (args.alt, KEY_LEFTALT)) if flag]
+
+    fd = os.open("/dev/uinput", os.O_WRONLY | os.O_NONBLOCK)
+    fcntl.ioctl(fd, UI_SET_EVBIT, EV_KEY)
+    # KEY_A and KEY_SPACE make it look like a keyboard to opentrack
+    for code in {key, KEYS["A"], KEYS["SPACE"], KEY_LEFTCTRL, KEY_LEFTSHIFT, KEY_LEFTALT}:
+        fcntl.ioctl(fd, UI_SET_KEYBIT, code)
+
+    # struct uinput_user_dev: name, input_id, ff_effects_max, 4 * 64 abs values
+    dev = struct.pack("80sHHHHi", NAME, 0x06, 0x1234, 0x5678, 1, 0) + bytes(4 * 64 * 4)
+    os.write(fd, dev)
+    fcntl.ioctl(fd, UI_DEV_CREATE)
+
+    time.sleep(.5)
+    for path in glob.glob("/sys/class/input/event*/device/name"):
+        with open(path, "rb") as f:
+            if f.read().strip() == NAME:
+                print("device: /dev/input/" + path.split("/")[4], flush=True)
+
+    headless = None
+    if args.check:
+        # it picks up devices on start, so after ours exists
+        out = tempfile.NamedTemporaryFile(suffix=".json", delete=False)
+        out.close()
+        cmd = [args.check, "--evdev-latency", out.name]
+        if args.profile:
+            cmd += ["--profile", args.profile]
+        headless = subprocess.Popen(cmd)
+        time.sleep(3)
+        if headless.poll() is not None:
+            fcntl.ioctl(fd, UI_DEV_DESTROY)
+            os.close(fd)
+            sys.exit("opentrack-headless exited with %d" % headless.returncode)
+
+    n = 0
+    try:
+        while not args.count or n < args.count:
+            time.sleep(max(0, args.interval - args.hold))
+            for code in mods:
+                emit(fd, EV_KEY, code, 1)
+            emit(fd, EV_KEY, key, 1)
+            emit(fd, EV_SYN, SYN_REPORT, 0)
+            time.sleep(args.hold)
+            emit(fd, EV_KEY, key, 0)
+            for code in mods:
+                emit(fd, EV_KEY, code, 0)
+            emit(fd, EV_SYN, SYN_REPORT, 0)
+            n += 1
+            print("press", n, flush=True)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if headless:
+            headless.send_signal(signal.SIGTERM)
+            headless.wait()
+        fcntl.ioctl(fd, UI_DEV_DESTROY)
+        os.close(fd)
+
+    if headless:
+        check(out.name, n, args.max_ms)
+
+
+def check(path, presses, max_ms):
+    try:
+        with open(path) as f:
+            latency = json.load(f)
+    except ValueError:
+        sys.exit("opentrack-headless wrote no latency to " + path)
+    finally:
+        os.unlink(path)
+
+    print("latency: %(count)d events, ms min %(min-ms).3f median %(median-ms).3f max %(max-ms).3f" % latency)
+
+    # a press, and a release unless the binding is held
+    if latency["count"] < presses:
+        sys.exit("measured %d events for %d presses, is the key bound?" % (latency["count"], presses))
+    if latency["max-ms"] > max_ms:
+        sys.exit("slowest binding took %.3f ms" % latency["max-ms"])
+
+
+if __name__ == "__main__":
+    main()
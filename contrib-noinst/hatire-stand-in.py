@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# Fake HAT-IRE Arduino on a pseudo-terminal, for testing the hatire tracker
+# without hardware. Prints the pty path to put in the tracker's serial port
+# setting (on Linux, Qt lists it only by full path, e.g. /dev/pts/5).
+#
+# usage: hatire-stand-in.py [--rate 250] [--big-endian] [--garbage 0.01]
+#                           [--link /tmp/ttyHAT]
+
+import argparse
+import math
+import os
+import pty
+import random
+import select
+import struct
+import sys
+import time
+import tty
+
+
+def frame(fmt, code, t):
+    rot = (40 * math.sin(t * 0.9), 25 * math.sin(t * 1.4), 10 * math.sin(t * 2.3))
+    trans = (5 * math.sin(t * 0.5), 3 * math.sin(t * 0.8), 8 * math.sin(t * 0.3))
+    return struct.pack(fmt, 0xAAAA, code, *rot, *trans, 0x5555)
+
+
+def main():
+    p = argparse.ArgumentParser()
+    p.add_argument("--rate", type=float, default=250, help="frames per second")
+    p.add_argument("--big-endian", action="store_true")
+    p.add_argument("--garbage", type=float, default=0, metavar="P",
+                   help="chance of inserting junk bytes before a frame")
+    p.add_argument("--link", help="also make a symlink to the pty here")
+    args = p.parse_args()
+
+    fmt = (">" if args.big_endian else "<") + "HH6fH"
+    assert struct.calcsize(fmt) == 30
+
+    master, slave = pty.openpty()
+    tty.setraw(slave)
+    name = os.ttyname(slave)
+    if args.link:
+        if os.path.islink(args.link):
+            os.unlink(args.link)
+        os.symlink(name, args.link)
+    print("serving on", name, file=sys.stderr)
+
+    period = 1. / args.rate
+    start = deadline = time.monotonic()
+    n = 0
+    last_report = start
+
+    try:
+        while True:
+            now = time.monotonic()
+            # commands from the tracker (init/start/stop/...) are echoed to
+            # stderr and otherwise ignored.
+            r, _, _ = select.select([master], [], [], max(0., deadline - now))
+            if r:
+                cmd = os.read(master, 256)
+                print("cmd:", cmd, file=sys.stderr)
+                continue
+            buf = frame(fmt, n % 1000, now - start)
+            if args.garbage and random.random() < args.garbage:
+                buf = os.urandom(random.randint(1, 40)) + buf
+            try:
+                os.write(master, buf)
+            except BlockingIOError:
+                pass
+            n += 1
+            deadline += period
+            if now - last_report >= 5:
+                print("%d frames, %.1f/s" % (n, n / (now - start)), file=sys.stderr)
+                last_report = now
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if args.link and os.path.islink(args.link):
+            os.unlink(args.link)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+# Stand-in for the S2Bot helper app, for testing and benchmarking the
+# s2bot tracker without hardware. Serves /poll like S2Bot does, plus
+# /stream which pushes samples as server-sent events over one connection.
+#
+# usage: s2bot-stand-in.py [--port 17317] [--rate 250]
+
+import argparse
+import math
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+def sample(t):
+    return ("accelerometerX %.3f\n"
+            "accelerometerY %.3f\n"
+            "accelerometerZ %.3f\n"
+            "bearing %.3f\n") % (30 * math.sin(t * 1.3),
+                                 20 * math.sin(t * 0.7),
+                                 10 * math.sin(t * 2.1),
+                                 (t * 20) % 360)
+
+
+class handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    rate = 250
+
+    def log_message(self, fmt, *args):
+        pass
+
+    def do_GET(self):
+        if self.path == "/poll":
+            body = sample(time.monotonic()).encode("ascii")
+            self.send_response(200)
+            self.send_header("Content-Type", "text/plain")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+        elif self.path == "/stream":
+            self.send_response(200)
+            self.send_header("Content-Type", "text/event-stream")
+            self.send_header("Cache-Control", "no-cache")
+            self.send_header("Connection", "close")
+            self.end_headers()
+            self.close_connection = True
+            n, start = 0, time.monotonic()
+            try:
+                while True:
+                    lines = sample(time.monotonic()).splitlines()
+                    event = "".join("data: %s\n" % x for x in lines) + "\n"
+                    self.wfile.write(event.encode("ascii"))
+                    self.wfile.flush()
+                    n += 1
+                    time.sleep(1. / self.rate)
+            except (BrokenPipeError, ConnectionResetError):
+                dt = time.monotonic() - start
+                print("stream closed after %d events, %.1f/s" % (n, n / max(dt, 1e-9)))
+        else:
+            self.send_error(404)
+
+
+def main():
+    p = argparse.ArgumentParser()
+    p.add_argument("--port", type=int, default=17317)
+    p.add_argument("--rate", type=float, default=250, help="stream events per second")
+    args = p.parse_args()
+    handler.rate = args.rate
+    ThreadingHTTPServer(("127.0.0.1", args.port), handler).serve_forever()
+
+
+if __name__ == "__main__":
+    main()
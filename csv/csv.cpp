@@ -96,7 +96,38 @@ bool CSV::getGameData(int id, unsigned char* table, QString& gamename)
     if (id != 0)
         qDebug() << "csv: lookup game id" << id;
 
-    QString id_str(QString::number(id));
+    const game_db& db = get_game_db();
+    const auto it = db.constFind(id);
+
+    if (it == db.cend())
+    {
+        if (id)
+            qDebug() << "unknown game connected" << id;
+
+        return false;
+    }
+
+    for (int i = 0; i < 8; i++)
+        table[i] = it->table[i];
+    gamename = it->name;
+
+    return true;
+}
+
+void CSV::preload()
+{
+    (void)get_game_db();
+}
+
+const CSV::game_db& CSV::get_game_db()
+{
+    static const game_db db = load_game_db();
+    return db;
+}
+
+CSV::game_db CSV::load_game_db()
+{
+    game_db db;
 
     static const QString csv_path(OPENTRACK_BASE_PATH +
                                   OPENTRACK_DOC_PATH "settings/facetracknoir supported games.csv");
@@ -106,7 +137,7 @@ bool CSV::getGameData(int id, unsigned char* table, QString& gamename)
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
     {
         qDebug() << "csv: can't open game list for freetrack protocol!";
-        return false;
+        return db;
     }
 
     CSV csv(&file);
@@ -130,45 +161,53 @@ bool CSV::getGameData(int id, unsigned char* table, QString& gamename)
 
         if (gameLine.count() == 8)
         {
-            if (gameLine.at(6).compare(id_str, Qt::CaseInsensitive) == 0)
-            {
-                const QString proto(std::move(gameLine.at(3)));
-                const QString name(std::move(gameLine.at(1)));
+            bool ok = false;
+            const int id = gameLine.at(6).toInt(&ok);
 
-                const QByteArray id_cstr = gameLine.at(7).toLatin1();
+            // header line, or a later duplicate of an id we already have
+            if (!ok || db.contains(id))
+                continue;
 
-                if (proto == QString("V160"))
-                {
-                    /* nothing */
-                }
-                else if (id_cstr.length() != 22 ||
-                         sscanf(id_cstr.constData(),
-                                "%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x",
-                                fuzz + 2,
-                                fuzz + 0,
-                                tmp + 3,
-                                tmp + 2,
-                                tmp + 1,
-                                tmp + 0,
-                                tmp + 7,
-                                tmp + 6,
-                                tmp + 5,
-                                tmp + 4,
-                                fuzz + 1) != 11)
-                {
-                    qDebug() << "scanf failed" << lineno;
-                }
-                else
+            const QString& proto(gameLine.at(3));
+
+            game_entry entry;
+            entry.name = gameLine.at(1);
+            for (int i = 0; i < 8; i++)
+                entry.table[i] = 0;
+
+            const QByteArray id_cstr = gameLine.at(7).toLatin1();
+
+            if (proto == QString("V160"))
+            {
+                /* nothing */
+            }
+            else if (id_cstr.length() != 22 ||
+                     sscanf(id_cstr.constData(),
+                            "%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x",
+                            fuzz + 2,
+                            fuzz + 0,
+                            tmp + 3,
+                            tmp + 2,
+                            tmp + 1,
+                            tmp + 0,
+                            tmp + 7,
+                            tmp + 6,
+                            tmp + 5,
+                            tmp + 4,
+                            fuzz + 1) != 11)
+            {
+                qDebug() << "scanf failed" << lineno;
+            }
+            else
+            {
+                for (int i = 0; i < 8; i++)
                 {
-                    for (int i = 0; i < 8; i++)
-                    {
-                        using t = unsigned char;
-                        table[i] = t(tmp[i]);
-                    }
+                    using t = unsigned char;
+                    entry.table[i] = t(tmp[i]);
                 }
-                gamename = std::move(name);
-                return true;
             }
+
+            db.insert(id, std::move(entry));
         }
         else
         {
@@ -176,8 +215,7 @@ bool CSV::getGameData(int id, unsigned char* table, QString& gamename)
         }
     }
 
-    if (id)
-        qDebug() << "unknown game connected" << id;
+    db.squeeze();
 
-    return false;
+    return db;
 }
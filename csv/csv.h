@@ -5,6 +5,8 @@
 #include <QIODevice>
 #include <QTextCodec>
 #include <QRegExp>
+#include <QHash>
+#include <QString>
 #include <QtGlobal>
 
 class CSV
@@ -14,9 +16,23 @@ public:
     bool parseLine(QStringList& ret);
 
     static bool getGameData(int gameID, unsigned char* table, QString& gamename);
+    // parse the game list up front so that lookups never touch the disk
+    static void preload();
 private:
     CSV(QIODevice* device);
 
+    struct game_entry
+    {
+        QString name;
+        unsigned char table[8];
+    };
+
+    // keyed by international id, immutable once built
+    using game_db = QHash<int, game_entry>;
+
+    static const game_db& get_game_db();
+    static game_db load_game_db();
+
     QIODevice* m_device;
     QString m_string;
     int m_pos;
@@ -0,0 +1,119 @@
+#include "idle-gate.hpp"
+
+#include <algorithm>
+
+#include <opencv2/imgproc.hpp>
+
+void idle_gate::set_timeout(double seconds)
+{
+    timeout_ms.store(seconds > 0 ? seconds * 1000 : 0, std::memory_order_relaxed);
+}
+
+bool idle_gate::motion(const cv::Mat& frame)
+{
+    const int h = std::max(1, frame.rows * thumb_width / std::max(1, frame.cols));
+    cv::resize(frame, thumb, cv::Size(thumb_width, h), 0, 0, cv::INTER_AREA);
+    if (thumb.channels() != 1)
+        cv::cvtColor(thumb, thumb, cv::COLOR_BGR2GRAY);
+
+    bool ret = false;
+
+    if (prev_thumb.size() == thumb.size())
+    {
+        cv::Mat diff;
+        cv::absdiff(thumb, prev_thumb, diff);
+        ret = cv::mean(diff)[0] > motion_thres;
+    }
+
+    cv::swap(thumb, prev_thumb);
+
+    return ret;
+}
+
+void idle_gate::account(double ms)
+{
+    busy_ms += ms;
+
+    const double elapsed = window.elapsed_ms();
+    if (elapsed >= window_ms)
+    {
+        load.store(busy_ms / elapsed, std::memory_order_relaxed);
+        busy_ms = 0;
+        window.start();
+    }
+}
+
+bool idle_gate::want_frame(const cv::Mat& frame)
+{
+    busy_timer.start();
+
+    if (!idle.load(std::memory_order_relaxed))
+        return true;
+
+    bool ret = false;
+
+    if (motion(frame))
+    {
+        if (!motion_seen)
+            reacquire_timer.start();
+        motion_seen = true;
+        ret = true;
+    }
+    else
+    {
+        motion_seen = false;
+        ret = since_probe.elapsed_ms() >= probe_ms;
+    }
+
+    if (ret)
+        since_probe.start();
+    else
+        account(busy_timer.elapsed_ms());
+
+    return ret;
+}
+
+bool idle_gate::done(bool found)
+{
+    account(busy_timer.elapsed_ms());
+
+    const bool was_idle = idle.load(std::memory_order_relaxed);
+
+    if (found)
+    {
+        since_found.start();
+
+        if (was_idle)
+        {
+            // found by the periodic probe without moving, that's this frame
+            reacquire_ms.store(motion_seen ? reacquire_timer.elapsed_ms() : busy_timer.elapsed_ms(),
+                               std::memory_order_relaxed);
+            reacquisitions.fetch_add(1, std::memory_order_relaxed);
+            idle.store(false, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    else if (!was_idle)
+    {
+        const double timeout = timeout_ms.load(std::memory_order_relaxed);
+        if (timeout > 0 && since_found.elapsed_ms() > timeout)
+        {
+            prev_thumb.release();
+            motion_seen = false;
+            since_probe.start();
+            idle.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    return false;
+}
+
+idle_gate::stats idle_gate::get_stats() const
+{
+    stats ret;
+    ret.idle = idle.load(std::memory_order_relaxed);
+    ret.load = load.load(std::memory_order_relaxed);
+    ret.reacquire_ms = reacquire_ms.load(std::memory_order_relaxed);
+    ret.reacquisitions = reacquisitions.load(std::memory_order_relaxed);
+    return ret;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// Lets a camera tracker stop processing every frame once it hasn't seen
+// its target for a while. While idle, each frame is only compared to the
+// previous one at a fraction of its size; full detection runs when that
+// shows motion, and on a slow periodic probe. The first detection ends
+// idling.
+
+#include "compat/timer.hpp"
+
+#include <atomic>
+
+#include <opencv2/core.hpp>
+
+class idle_gate final
+{
+public:
+    struct stats final
+    {
+        bool idle = false;
+        // share of wall time spent on frames, over the last second
+        double load = 0;
+        // from the start of the motion that ended idling to the detection
+        double reacquire_ms = 0;
+        unsigned reacquisitions = 0;
+    };
+
+    // seconds without detection before idling, 0 never idles
+    void set_timeout(double seconds);
+
+    // call for each frame, then `done' if it returned true
+    bool want_frame(const cv::Mat& frame);
+    // whether the target was found in the frame. returns true when this
+    // ended idling.
+    bool done(bool found);
+
+    stats get_stats() const;
+    bool is_idle() const { return idle.load(std::memory_order_relaxed); }
+
+private:
+    bool motion(const cv::Mat& frame);
+    void account(double ms);
+
+    static constexpr inline double probe_ms = 500;
+    static constexpr inline double window_ms = 1000;
+    // mean absolute difference of the thumbnails, in gray levels
+    static constexpr inline double motion_thres = 3;
+    static constexpr inline int thumb_width = 80;
+
+    cv::Mat thumb, prev_thumb;
+    Timer since_found, since_probe, window, busy_timer, reacquire_timer;
+    double busy_ms = 0;
+    bool motion_seen = false;
+
+    std::atomic<double> timeout_ms { 0 };
+    std::atomic<bool> idle { false };
+    std::atomic<double> load { 0 }, reacquire_ms { 0 };
+    std::atomic<unsigned> reacquisitions { 0 };
+};
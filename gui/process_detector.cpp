@@ -185,7 +185,7 @@ bool process_detector_worker::should_stop()
         return false;
     }
 
-    QStringList exe_list = get_all_executable_names();
+    const QSet<QString> exe_list = get_all_executable_names();
 
     if (exe_list.contains(last_exe_name))
         return false;
@@ -205,7 +205,7 @@ bool process_detector_worker::config_to_start(QString& str)
     }
 
     auto filenames = s.split_process_names();
-    QStringList exe_list = get_all_executable_names();
+    const QSet<QString> exe_list = get_all_executable_names();
 
     // assuming manual stop by user button click.
     // don't automatically start again while the same process is running.
@@ -214,15 +214,17 @@ bool process_detector_worker::config_to_start(QString& str)
     // it's gone, we can start automatically again
     last_exe_name = "";
 
-    for (auto& name : exe_list)
-    {
-        if (filenames.contains(name))
-        {
-            last_exe_name = name;
-            str = filenames[name];
-            return str != "";
-        }
-    }
+    // few configured executables, many processes. when several are
+    // running, the first in the dialog's sorted list wins.
+    const QString* found = nullptr;
+    for (auto it = filenames.cbegin(); it != filenames.cend(); it++)
+        if (exe_list.contains(it.key()) && (!found || it.key() < *found))
+            found = &it.key();
+
+    if (!found)
+        return false;
 
-    return false;
+    last_exe_name = *found;
+    str = filenames.value(*found);
+    return str != "";
 }
@@ -102,6 +102,16 @@ options_dialog::options_dialog(std::function<void(bool)> pause_keybindings) :
 
     tie_setting(main.neck_enable, ui.neck_enable);
 
+#ifdef __linux__
+    tie_setting(main.evdev_shortcuts, ui.evdev_shortcuts);
+    tie_setting(main.evdev_devices, ui.evdev_devices);
+    ui.evdev_devices->setEnabled(main.evdev_shortcuts);
+    connect(ui.evdev_shortcuts, &QCheckBox::toggled, ui.evdev_devices, &QLineEdit::setEnabled);
+#else
+    ui.evdev_shortcuts->hide();
+    ui.evdev_devices->hide();
+#endif
+
     const bool is_translation_disabled = group::with_global_settings_object([] (QSettings& s) {
         return s.value("disable-translation", false).toBool();
     });
@@ -0,0 +1,117 @@
+#include "thread-usage.hpp"
+#include "compat/library-path.hpp"
+
+#include <QVBoxLayout>
+#include <QDialogButtonBox>
+#include <QPushButton>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDir>
+
+enum column : int
+{
+    col_name, col_load, col_cpu, col_ticks, col_allocs, col_allocating_ticks, col_max_allocs,
+    col_count,
+};
+
+thread_usage_dialog::thread_usage_dialog()
+{
+    setWindowTitle(tr("Thread usage"));
+
+    table.setColumnCount(col_count);
+    table.setHorizontalHeaderLabels({
+        tr("Thread"), tr("CPU %"), tr("CPU time (s)"), tr("Ticks"),
+        tr("Allocations"), tr("Ticks allocating"), tr("Most in a tick"),
+    });
+    table.verticalHeader()->hide();
+    table.setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table.setSelectionMode(QAbstractItemView::NoSelection);
+    table.horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    table.setMinimumSize(640, 200);
+
+    if (!thread_monitor::counts_allocations())
+    {
+        for (int i : { col_allocs, col_allocating_ticks, col_max_allocs })
+            table.setColumnHidden(i, true);
+        note.setText(tr("Allocations are only counted in builds with opentrack_count-allocations."));
+    }
+    else
+        note.setText(tr("A tick is a pipeline iteration or a camera frame."));
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    QPushButton* save_button = buttons->addButton(tr("Save as JSON..."), QDialogButtonBox::ActionRole);
+
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::close);
+    connect(save_button, &QPushButton::clicked, this, &thread_usage_dialog::save);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(&table);
+    layout->addWidget(&note);
+    layout->addWidget(buttons);
+
+    connect(&timer, &QTimer::timeout, this, &thread_usage_dialog::refresh);
+    timer.start(1000);
+
+    refresh();
+}
+
+void thread_usage_dialog::refresh()
+{
+    last = thread_monitor::sample(last);
+    const std::vector<thread_monitor::usage>& xs = last;
+
+    table.setRowCount(int(xs.size()));
+
+    for (int row = 0; row < int(xs.size()); row++)
+    {
+        const thread_monitor::usage& x = xs[unsigned(row)];
+
+        const QString cells[col_count] = {
+            x.name,
+            QString::number(x.load * 100, 'f', 1),
+            QString::number(x.cpu_ms / 1000, 'f', 1),
+            QString::number(x.ticks),
+            QString::number(x.allocations),
+            QString::number(x.allocating_ticks),
+            QString::number(x.max_tick_allocations),
+        };
+
+        for (int col = 0; col < col_count; col++)
+        {
+            QTableWidgetItem* item = table.item(row, col);
+            if (!item)
+            {
+                item = new QTableWidgetItem;
+                if (col != col_name)
+                    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+                table.setItem(row, col, item);
+            }
+            item->setText(cells[col]);
+        }
+    }
+}
+
+void thread_usage_dialog::save()
+{
+    const QString filename = QFileDialog::getSaveFileName(this, tr("Save thread usage"),
+                                                          OPENTRACK_BASE_PATH,
+                                                          tr("JSON file (*.json)"));
+    // dialog likes to mess with current directory
+    QDir::setCurrent(OPENTRACK_BASE_PATH);
+
+    if (filename.isEmpty())
+        return;
+
+    const QJsonObject ret {
+        { "counts-allocations", thread_monitor::counts_allocations() },
+        // what's on screen, the load over the last refresh interval
+        { "threads", thread_monitor::to_json(last) },
+    };
+
+    QFile f(filename);
+    if (f.open(QFile::WriteOnly | QFile::Truncate))
+        f.write(QJsonDocument(ret).toJson());
+}
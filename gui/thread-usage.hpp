@@ -0,0 +1,30 @@
+#pragma once
+
+#include "export.hpp"
+#include "compat/thread-monitor.hpp"
+
+#include <vector>
+
+#include <QDialog>
+#include <QTimer>
+#include <QTableWidget>
+#include <QLabel>
+
+// CPU time and allocations of the threads that have a thread_monitor,
+// refreshed every second.
+
+class OTR_GUI_EXPORT thread_usage_dialog final : public QDialog
+{
+    Q_OBJECT
+public:
+    thread_usage_dialog();
+private:
+    QTableWidget table;
+    QLabel note;
+    QTimer timer;
+    // the load shown is over the time since the previous refresh
+    std::vector<thread_monitor::usage> last;
+
+    void refresh();
+    void save();
+};
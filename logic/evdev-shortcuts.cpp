@@ -0,0 +1,392 @@
+#ifdef __linux__
+
+#include "evdev-shortcuts.hpp"
+
+#include <QDir>
+#include <QKeySequence>
+#include <QMutexLocker>
+#include <QDebug>
+
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <iterator>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+
+static const struct { int qt, code; } key_table[] =
+{
+    { Qt::Key_A, KEY_A }, { Qt::Key_B, KEY_B }, { Qt::Key_C, KEY_C }, { Qt::Key_D, KEY_D },
+    { Qt::Key_E, KEY_E }, { Qt::Key_F, KEY_F }, { Qt::Key_G, KEY_G }, { Qt::Key_H, KEY_H },
+    { Qt::Key_I, KEY_I }, { Qt::Key_J, KEY_J }, { Qt::Key_K, KEY_K }, { Qt::Key_L, KEY_L },
+    { Qt::Key_M, KEY_M }, { Qt::Key_N, KEY_N }, { Qt::Key_O, KEY_O }, { Qt::Key_P, KEY_P },
+    { Qt::Key_Q, KEY_Q }, { Qt::Key_R, KEY_R }, { Qt::Key_S, KEY_S }, { Qt::Key_T, KEY_T },
+    { Qt::Key_U, KEY_U }, { Qt::Key_V, KEY_V }, { Qt::Key_W, KEY_W }, { Qt::Key_X, KEY_X },
+    { Qt::Key_Y, KEY_Y }, { Qt::Key_Z, KEY_Z },
+
+    { Qt::Key_0, KEY_0 }, { Qt::Key_1, KEY_1 }, { Qt::Key_2, KEY_2 }, { Qt::Key_3, KEY_3 },
+    { Qt::Key_4, KEY_4 }, { Qt::Key_5, KEY_5 }, { Qt::Key_6, KEY_6 }, { Qt::Key_7, KEY_7 },
+    { Qt::Key_8, KEY_8 }, { Qt::Key_9, KEY_9 },
+
+    { Qt::Key_F1, KEY_F1 }, { Qt::Key_F2, KEY_F2 }, { Qt::Key_F3, KEY_F3 }, { Qt::Key_F4, KEY_F4 },
+    { Qt::Key_F5, KEY_F5 }, { Qt::Key_F6, KEY_F6 }, { Qt::Key_F7, KEY_F7 }, { Qt::Key_F8, KEY_F8 },
+    { Qt::Key_F9, KEY_F9 }, { Qt::Key_F10, KEY_F10 }, { Qt::Key_F11, KEY_F11 }, { Qt::Key_F12, KEY_F12 },
+    { Qt::Key_F13, KEY_F13 }, { Qt::Key_F14, KEY_F14 }, { Qt::Key_F15, KEY_F15 }, { Qt::Key_F16, KEY_F16 },
+    { Qt::Key_F17, KEY_F17 }, { Qt::Key_F18, KEY_F18 }, { Qt::Key_F19, KEY_F19 }, { Qt::Key_F20, KEY_F20 },
+    { Qt::Key_F21, KEY_F21 }, { Qt::Key_F22, KEY_F22 }, { Qt::Key_F23, KEY_F23 }, { Qt::Key_F24, KEY_F24 },
+
+    { Qt::Key_Escape, KEY_ESC }, { Qt::Key_Tab, KEY_TAB }, { Qt::Key_Backspace, KEY_BACKSPACE },
+    { Qt::Key_Return, KEY_ENTER }, { Qt::Key_Enter, KEY_KPENTER }, { Qt::Key_Space, KEY_SPACE },
+    { Qt::Key_Insert, KEY_INSERT }, { Qt::Key_Delete, KEY_DELETE }, { Qt::Key_Pause, KEY_PAUSE },
+    { Qt::Key_Print, KEY_SYSRQ }, { Qt::Key_Home, KEY_HOME }, { Qt::Key_End, KEY_END },
+    { Qt::Key_PageUp, KEY_PAGEUP }, { Qt::Key_PageDown, KEY_PAGEDOWN },
+    { Qt::Key_Left, KEY_LEFT }, { Qt::Key_Up, KEY_UP }, { Qt::Key_Right, KEY_RIGHT }, { Qt::Key_Down, KEY_DOWN },
+    { Qt::Key_CapsLock, KEY_CAPSLOCK }, { Qt::Key_ScrollLock, KEY_SCROLLLOCK }, { Qt::Key_Menu, KEY_COMPOSE },
+
+    { Qt::Key_Minus, KEY_MINUS }, { Qt::Key_Equal, KEY_EQUAL },
+    { Qt::Key_BracketLeft, KEY_LEFTBRACE }, { Qt::Key_BracketRight, KEY_RIGHTBRACE },
+    { Qt::Key_Semicolon, KEY_SEMICOLON }, { Qt::Key_Apostrophe, KEY_APOSTROPHE },
+    { Qt::Key_QuoteLeft, KEY_GRAVE }, { Qt::Key_Backslash, KEY_BACKSLASH },
+    { Qt::Key_Comma, KEY_COMMA }, { Qt::Key_Period, KEY_DOT }, { Qt::Key_Slash, KEY_SLASH },
+};
+
+// with Qt::KeypadModifier
+static const struct { int qt, code; } keypad_table[] =
+{
+    { Qt::Key_0, KEY_KP0 }, { Qt::Key_1, KEY_KP1 }, { Qt::Key_2, KEY_KP2 }, { Qt::Key_3, KEY_KP3 },
+    { Qt::Key_4, KEY_KP4 }, { Qt::Key_5, KEY_KP5 }, { Qt::Key_6, KEY_KP6 }, { Qt::Key_7, KEY_KP7 },
+    { Qt::Key_8, KEY_KP8 }, { Qt::Key_9, KEY_KP9 },
+    { Qt::Key_Asterisk, KEY_KPASTERISK }, { Qt::Key_Minus, KEY_KPMINUS }, { Qt::Key_Plus, KEY_KPPLUS },
+    { Qt::Key_Slash, KEY_KPSLASH }, { Qt::Key_Period, KEY_KPDOT }, { Qt::Key_Enter, KEY_KPENTER },
+    // with numlock off
+    { Qt::Key_Insert, KEY_KP0 }, { Qt::Key_End, KEY_KP1 }, { Qt::Key_Down, KEY_KP2 },
+    { Qt::Key_PageDown, KEY_KP3 }, { Qt::Key_Left, KEY_KP4 }, { Qt::Key_Clear, KEY_KP5 },
+    { Qt::Key_Right, KEY_KP6 }, { Qt::Key_Home, KEY_KP7 }, { Qt::Key_Up, KEY_KP8 },
+    { Qt::Key_PageUp, KEY_KP9 }, { Qt::Key_Delete, KEY_KPDOT },
+};
+
+static const struct { int code; unsigned mod; } modifier_table[] =
+{
+    { KEY_LEFTCTRL, Qt::ControlModifier }, { KEY_RIGHTCTRL, Qt::ControlModifier },
+    { KEY_LEFTSHIFT, Qt::ShiftModifier }, { KEY_RIGHTSHIFT, Qt::ShiftModifier },
+    { KEY_LEFTALT, Qt::AltModifier }, { KEY_RIGHTALT, Qt::AltModifier },
+    { KEY_LEFTMETA, Qt::MetaModifier }, { KEY_RIGHTMETA, Qt::MetaModifier },
+};
+
+static constexpr unsigned modifier_mask = Qt::ControlModifier | Qt::ShiftModifier | Qt::AltModifier | Qt::MetaModifier;
+
+static bool test_bit(const unsigned long* bits, int i)
+{
+    constexpr int sz = sizeof(*bits) * 8;
+    return bits[i / sz] >> (i % sz) & 1;
+}
+
+static double monotonic_ms()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+evdev_shortcuts::evdev_shortcuts(const QString& paths)
+{
+    if (paths.trimmed().isEmpty())
+    {
+        const QDir dir("/dev/input");
+        for (const QString& name : dir.entryList({ "event*" }, QDir::System, QDir::Name))
+            open_device(dir.filePath(name), true);
+    }
+    else
+    {
+        for (const QString& path : paths.split(';', QString::SkipEmptyParts))
+            open_device(path.trimmed(), false);
+    }
+
+    if (devices.empty())
+    {
+        qDebug() << "evdev: no input devices, check the permissions on /dev/input";
+        return;
+    }
+
+    if (pipe2(wake, O_CLOEXEC | O_NONBLOCK))
+    {
+        qDebug() << "evdev: pipe2" << errno;
+        for (const device& dev : devices)
+            close(dev.fd);
+        devices.clear();
+        return;
+    }
+
+    start(QThread::HighPriority);
+}
+
+evdev_shortcuts::~evdev_shortcuts()
+{
+    if (isRunning())
+    {
+        const char c = 0;
+        (void)write(wake[1], &c, 1);
+        wait();
+    }
+
+    if (const latency_stats x = latency(); x.count)
+        qDebug() << "evdev: latency over" << x.count << "events, ms"
+                 << "min" << x.min << "median" << x.median << "max" << x.max;
+
+    for (int fd : wake)
+        if (fd != -1)
+            close(fd);
+
+    for (const device& dev : devices)
+        close(dev.fd);
+}
+
+void evdev_shortcuts::open_device(const QString& path, bool only_with_keys)
+{
+    const int fd = open(path.toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        if (!only_with_keys)
+            qDebug() << "evdev: can't open" << path << "errno" << errno;
+        return;
+    }
+
+    unsigned long keys[KEY_CNT / (sizeof(long) * 8) + 1] {};
+    char name[256] {};
+
+    if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) < 0 ||
+        ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name) < 0)
+    {
+        close(fd);
+        return;
+    }
+
+    // skip mice and power buttons when picking devices ourselves
+    const bool is_keyboard = test_bit(keys, KEY_A) && test_bit(keys, KEY_SPACE);
+    const bool is_joystick = test_bit(keys, BTN_JOYSTICK) || test_bit(keys, BTN_GAMEPAD);
+
+    if (only_with_keys && !is_keyboard && !is_joystick)
+    {
+        close(fd);
+        return;
+    }
+
+    // timestamps on the same clock as monotonic_ms(), for measuring latency
+    int clock = CLOCK_MONOTONIC;
+    (void)ioctl(fd, EVIOCSCLOCKID, &clock);
+
+    device dev { fd, path, QString::fromLocal8Bit(name), {} };
+
+    // joystick and gamepad buttons in code order, then the extra ones
+    for (int i = BTN_JOYSTICK; i <= BTN_THUMBR; i++)
+        if (test_bit(keys, i))
+            dev.buttons.push_back(i);
+    for (int i = BTN_TRIGGER_HAPPY1; i <= BTN_TRIGGER_HAPPY40; i++)
+        if (test_bit(keys, i))
+            dev.buttons.push_back(i);
+
+    qDebug() << "evdev: reading" << path << dev.name;
+
+    devices.push_back(std::move(dev));
+}
+
+bool evdev_shortcuts::make_binding(const key_opts& k, binding& b) const
+{
+    if (!k.guid().isEmpty())
+    {
+        const int idx = k.button & ~Qt::KeyboardModifierMask;
+
+        for (const device& dev : devices)
+        {
+            if (dev.name == k.guid() && idx >= 0 && idx < (int)dev.buttons.size())
+            {
+                b.device = dev.name;
+                b.code = dev.buttons[idx];
+                b.mods = k.button & modifier_mask;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    const QKeySequence seq = QKeySequence::fromString(k.keycode, QKeySequence::PortableText);
+
+    if (seq.isEmpty())
+        return false;
+
+    const int key = seq[0] & ~Qt::KeyboardModifierMask;
+
+    if (seq[0] & Qt::KeypadModifier)
+    {
+        for (const auto& x : keypad_table)
+            if (x.qt == key)
+            {
+                b.code = x.code;
+                b.mods = seq[0] & modifier_mask;
+                return true;
+            }
+    }
+
+    for (const auto& x : key_table)
+        if (x.qt == key)
+        {
+            b.code = x.code;
+            b.mods = seq[0] & modifier_mask;
+            return true;
+        }
+
+    qDebug() << "evdev: no key code for" << k.keycode();
+
+    return false;
+}
+
+void evdev_shortcuts::reload(const t_keys& keys)
+{
+    QMutexLocker l(&mtx);
+
+    bindings.clear();
+
+    for (const t_key& k : keys)
+    {
+        binding b { std::get<1>(k), QString(), 0, 0, std::get<2>(k), false };
+        if (make_binding(std::get<0>(k), b))
+            bindings.push_back(std::move(b));
+    }
+}
+
+evdev_shortcuts::latency_stats evdev_shortcuts::latency() const
+{
+    std::vector<double> xs;
+    {
+        QMutexLocker l(&mtx);
+        xs = latencies;
+    }
+
+    latency_stats ret;
+
+    if (xs.empty())
+        return ret;
+
+    std::sort(xs.begin(), xs.end());
+    ret.count = xs.size();
+    ret.min = xs.front();
+    ret.median = xs[xs.size() / 2];
+    ret.max = xs.back();
+
+    return ret;
+}
+
+void evdev_shortcuts::key_event(const device& dev, int code, int value, double t)
+{
+    for (const auto& x : modifier_table)
+        if (x.code == code)
+        {
+            // one bit for each side, so either of them being held counts
+            const unsigned bit = 1u << (&x - modifier_table);
+            mods = value ? mods | bit : mods & ~bit;
+            return;
+        }
+
+    unsigned held_mods = 0;
+    for (const auto& x : modifier_table)
+        if (mods & 1u << (&x - modifier_table))
+            held_mods |= x.mod;
+
+    QMutexLocker l(&mtx);
+
+    for (binding& b : bindings)
+    {
+        if (b.code != code || (!b.device.isEmpty() && b.device != dev.name))
+            continue;
+
+        if (value)
+        {
+            if (b.mods != held_mods || b.down)
+                continue;
+            b.down = true;
+            b.f(true);
+        }
+        else
+        {
+            // modifiers may have been let go first
+            if (!b.down)
+                continue;
+            b.down = false;
+            if (b.held)
+                continue;
+            b.f(false);
+        }
+
+        // ring buffer, the oldest sample goes first
+        const double ms = monotonic_ms() - t;
+        if (latencies.size() < latency_samples)
+            latencies.push_back(ms);
+        else
+            latencies[latency_count % latency_samples] = ms;
+        latency_count++;
+    }
+}
+
+void evdev_shortcuts::run()
+{
+    std::vector<pollfd> fds;
+    fds.push_back({ wake[0], POLLIN, 0 });
+    for (const device& dev : devices)
+        fds.push_back({ dev.fd, POLLIN, 0 });
+
+    for (;;)
+    {
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            qDebug() << "evdev: poll" << errno;
+            break;
+        }
+
+        if (fds[0].revents)
+            break;
+
+        for (unsigned i = 1; i < fds.size(); i++)
+        {
+            if (!fds[i].revents)
+                continue;
+
+            const device& dev = devices[i - 1];
+            input_event evs[64];
+            ssize_t sz;
+
+            while ((sz = read(dev.fd, evs, sizeof(evs))) > 0)
+            {
+                for (unsigned k = 0; k < sz / sizeof(*evs); k++)
+                {
+                    const input_event& ev = evs[k];
+
+                    if (ev.type == EV_SYN && ev.code == SYN_DROPPED)
+                        mods = 0;
+
+                    // autorepeat has value 2
+                    if (ev.type != EV_KEY || ev.value > 1)
+                        continue;
+
+                    key_event(dev, ev.code, ev.value, ev.input_event_sec * 1e3 + ev.input_event_usec * 1e-3);
+                }
+            }
+
+            if (sz == 0 || (sz < 0 && errno != EAGAIN && errno != EINTR))
+            {
+                qDebug() << "evdev: lost" << dev.path << "errno" << errno;
+                // unplugged, stop polling it
+                fds[i].fd = -1;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "main-settings.hpp"
+#include "export.hpp"
+
+#include <functional>
+#include <tuple>
+#include <vector>
+
+#include <QThread>
+#include <QMutex>
+#include <QString>
+
+// Reads keyboard and joystick events straight from /dev/input on its own
+// thread, so bindings fire even while the GUI thread is busy, and release
+// events make the "held" bindings work. Needs read access to the event
+// devices, which usually means membership in the `input' group.
+//
+// Keyboard bindings use the same Qt key sequences as the global shortcuts.
+// Joystick bindings use the key_opts guid as the device name and the
+// button as an index into the device's buttons, as on Windows.
+
+class OTR_LOGIC_EXPORT evdev_shortcuts final : private QThread
+{
+public:
+    using fun = std::function<void(bool)>;
+    using t_key = std::tuple<key_opts&, fun, bool>;
+    using t_keys = std::vector<t_key>;
+
+    // `paths' separated by ';', or empty for every device having keys
+    explicit evdev_shortcuts(const QString& paths);
+    ~evdev_shortcuts() override;
+
+    // from the kernel's event timestamp to the binding having run, over
+    // the last `latency_samples' events that fired one
+    struct latency_stats
+    {
+        unsigned count = 0;
+        double min = 0, median = 0, max = 0;
+    };
+
+    void reload(const t_keys& keys);
+    bool is_open() const { return !devices.empty(); }
+    latency_stats latency() const;
+
+private:
+    struct device
+    {
+        int fd;
+        QString path, name;
+        std::vector<int> buttons;
+    };
+
+    struct binding
+    {
+        fun f;
+        QString device;
+        int code;
+        unsigned mods;
+        bool held, down;
+    };
+
+    void run() override;
+    void open_device(const QString& path, bool only_with_keys);
+    bool make_binding(const key_opts& k, binding& b) const;
+    void key_event(const device& dev, int code, int value, double latency_start);
+
+    std::vector<device> devices;
+    std::vector<binding> bindings;
+    std::vector<double> latencies;
+    unsigned latency_count = 0;
+    mutable QMutex mtx;
+    unsigned mods = 0;
+    int wake[2] { -1, -1 };
+
+    static constexpr inline unsigned latency_samples = 1024;
+};
+
+#endif
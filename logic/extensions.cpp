@@ -1,7 +1,15 @@
 #include "extensions.hpp"
+#include "compat/timer.hpp"
 
+#include <algorithm>
 #include <functional>
 
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QDebug>
+
 using namespace options;
 
 using ext_fun_type = void(IExtension::*)(Pose&);
@@ -13,11 +21,12 @@ static constexpr struct event_type_mapping
     ext_fun_type ptr;
     ext_mask mask;
     ext_ord idx;
+    const char* name;
 } ordinal_to_function[] = {
-    { &IExtension::process_raw, ext_mask::on_raw, ext_ord::ev_raw, },
-    { &IExtension::process_before_filter, ext_mask::on_before_filter, ext_ord::ev_before_filter, },
-    { &IExtension::process_before_mapping, ext_mask::on_before_mapping, ext_ord::ev_before_mapping, },
-    { &IExtension::process_finished, ext_mask::on_finished, ext_ord::ev_finished, },
+    { &IExtension::process_raw, ext_mask::on_raw, ext_ord::ev_raw, "raw", },
+    { &IExtension::process_before_filter, ext_mask::on_before_filter, ext_ord::ev_before_filter, "before-filter", },
+    { &IExtension::process_before_mapping, ext_mask::on_before_mapping, ext_ord::ev_before_mapping, "before-mapping", },
+    { &IExtension::process_finished, ext_mask::on_finished, ext_ord::ev_finished, "finished", },
 };
 
 bool event_handler::is_enabled(const QString& name)
@@ -33,10 +42,96 @@ bool event_handler::is_enabled(const QString& name)
 #endif
 }
 
+// hands poses to extensions that only observe them. the pipeline never
+// waits; a pose that's still pending when the next one comes is replaced.
+struct event_handler::observer_thread final : QThread
+{
+    explicit observer_thread(event_handler& ev);
+    ~observer_thread() override;
+
+    void post(event_ordinal k, const Pose& pose);
+    void run() override;
+
+    event_handler& ev;
+
+    QMutex mtx;
+    QWaitCondition cond;
+    std::array<Pose, IExtension::event_count> pending;
+    std::array<bool, IExtension::event_count> have_pending {};
+    bool quit = false;
+};
+
+event_handler::observer_thread::observer_thread(event_handler& ev) : ev(ev)
+{
+    start(QThread::LowPriority);
+}
+
+event_handler::observer_thread::~observer_thread()
+{
+    {
+        QMutexLocker l(&mtx);
+        quit = true;
+        cond.wakeOne();
+    }
+    wait();
+}
+
+void event_handler::observer_thread::post(event_ordinal k, const Pose& pose)
+{
+    QMutexLocker l(&mtx);
+
+    if (have_pending[k])
+        for (extension& x : ev.observers_for_event[k])
+            x.time->dropped.fetch_add(1, std::memory_order_relaxed);
+
+    pending[k] = pose;
+    have_pending[k] = true;
+    cond.wakeOne();
+}
+
+void event_handler::observer_thread::run()
+{
+    std::array<Pose, IExtension::event_count> poses;
+    std::array<bool, IExtension::event_count> have;
+
+    for (;;)
+    {
+        {
+            QMutexLocker l(&mtx);
+
+            while (!quit && std::find(have_pending.cbegin(), have_pending.cend(), true) == have_pending.cend())
+                cond.wait(&mtx);
+
+            if (quit)
+                break;
+
+            poses = pending;
+            have = have_pending;
+            have_pending = {};
+        }
+
+        // in pipeline order
+        for (unsigned k = 0; k < IExtension::event_count; k++)
+            if (have[k])
+                for (extension& x : ev.observers_for_event[k])
+                {
+                    Pose copy = poses[k];
+                    ev.call(event_ordinal(k), x, copy);
+                }
+    }
+}
+
 event_handler::event_handler(Modules::dylib_list const& extensions) : ext_bundle(make_bundle("extensions"))
 {
+    // the pipeline runs every 4 ms, and that has to fit the tracker,
+    // filter and protocol as well
+    budget_ns = budget_usecs * 1000LL;
+
     for (std::shared_ptr<dylib> const& lib : extensions)
     {
+        if (!lib->load())
+            continue;
+
         std::shared_ptr<IExtension> ext(reinterpret_cast<IExtension*>(lib->Constructor()));
         std::shared_ptr<IExtensionDialog> dlg(reinterpret_cast<IExtensionDialog*>(lib->Dialog()));
         std::shared_ptr<Metadata> m(reinterpret_cast<Metadata*>(lib->Meta()));
@@ -46,6 +141,8 @@ event_handler::event_handler(Modules::dylib_list const& extensions) : ext_bundle
         if (!is_enabled(lib->module_name))
             continue;
 
+        auto& lists = ext->observe_only() ? observers_for_event : extensions_for_event;
+
 #if 0
         qDebug() << "extension" << lib->module_name << "mask" << (void*)mask;
 #endif
@@ -56,16 +153,96 @@ event_handler::event_handler(Modules::dylib_list const& extensions) : ext_bundle
             const ext_mask mask_ = mapping.mask;
 
             if (mask & mask_)
-                extensions_for_event[i].push_back({ ext, dlg, m });
+                lists[i].push_back({ ext, dlg, m, lib->module_name, std::make_unique<timing>() });
         }
     }
+
+    for (const ext_list& list : observers_for_event)
+        if (!list.empty())
+        {
+            observers = std::make_unique<observer_thread>(*this);
+            break;
+        }
 }
 
-void event_handler::run_events(event_ordinal k, Pose& pose)
+event_handler::~event_handler()
+{
+    // before the extensions go away
+    observers = nullptr;
+
+    for (const stats& x : get_stats())
+        if (x.calls)
+            qDebug() << "extension" << x.name << ordinal_to_function[x.event].name
+                     << "calls" << x.calls << "avg" << x.avg_us << "us max" << x.max_us << "us"
+                     << "over budget" << x.over_budget << "dropped" << x.dropped;
+}
+
+bool event_handler::empty() const
+{
+    // observers get a copy of the pose, they can't change the output
+    for (const ext_list& list : extensions_for_event)
+        if (!list.empty())
+            return false;
+    return true;
+}
+
+void event_handler::call(event_ordinal k, extension& x, Pose& pose)
 {
     auto fun = std::mem_fn(ordinal_to_function[k].ptr);
+    timing& t = *x.time;
 
+    Timer timer;
+    fun(*x.logic, pose);
+    const long long ns = timer.elapsed_nsecs();
+
+    // only ever written from one thread
+    const unsigned long long n = t.calls.load(std::memory_order_relaxed) + 1;
+    t.calls.store(n, std::memory_order_relaxed);
+    t.total_ns.store(t.total_ns.load(std::memory_order_relaxed) + (unsigned long long)ns, std::memory_order_relaxed);
+    if ((unsigned long long)ns > t.max_ns.load(std::memory_order_relaxed))
+        t.max_ns.store((unsigned long long)ns, std::memory_order_relaxed);
+
+    if (ns > budget_ns)
+    {
+        const unsigned long long over = t.over_budget.load(std::memory_order_relaxed) + 1;
+        t.over_budget.store(over, std::memory_order_relaxed);
+
+        // 1st, 2nd, 4th, 8th... time, so a slow extension doesn't flood the log
+        if ((over & (over - 1)) == 0)
+            qDebug() << "extension" << x.name << ordinal_to_function[k].name << "took" << ns / 1000 << "us,"
+                     << "budget" << budget_ns / 1000 << "us," << over << "times out of" << n;
+    }
+}
+
+void event_handler::run_events(event_ordinal k, Pose& pose)
+{
     for (extension& x : extensions_for_event[k])
-        fun(*x.logic, pose);
+        call(k, x, pose);
+
+    if (!observers_for_event[k].empty())
+        observers->post(k, pose);
 }
 
+std::vector<event_handler::stats> event_handler::get_stats() const
+{
+    std::vector<stats> ret;
+
+    for (const auto* lists : { &extensions_for_event, &observers_for_event })
+        for (unsigned k = 0; k < IExtension::event_count; k++)
+            for (const extension& x : (*lists)[k])
+            {
+                const timing& t = *x.time;
+                const unsigned long long calls = t.calls.load(std::memory_order_relaxed);
+
+                ret.push_back({
+                    x.name, event_ordinal(k), lists == &observers_for_event,
+                    calls,
+                    t.over_budget.load(std::memory_order_relaxed),
+                    t.dropped.load(std::memory_order_relaxed),
+                    calls ? t.total_ns.load(std::memory_order_relaxed) * 1e-3 / calls : 0,
+                    t.max_ns.load(std::memory_order_relaxed) * 1e-3,
+                });
+            }
+
+    return ret;
+}
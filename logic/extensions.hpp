@@ -10,6 +10,8 @@
 #include "api/plugin-support.hpp"
 #include "options/options.hpp"
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <array>
 
@@ -19,6 +21,15 @@ struct OTR_LOGIC_EXPORT event_handler final
 {
     using event_ordinal = IExtension::event_ordinal;
 
+    struct timing
+    {
+        std::atomic<unsigned long long> calls { 0 }, total_ns { 0 }, max_ns { 0 };
+        // calls that took longer than the budget
+        std::atomic<unsigned long long> over_budget { 0 };
+        // poses an observer didn't get to before the next one came
+        std::atomic<unsigned long long> dropped { 0 };
+    };
+
     struct extension
     {
         using ext = std::shared_ptr<IExtension>;
@@ -28,17 +39,44 @@ struct OTR_LOGIC_EXPORT event_handler final
         ext logic;
         dlg dialog;
         m metadata;
+        QString name;
+        std::unique_ptr<timing> time;
+    };
+
+    struct stats final
+    {
+        QString name;
+        event_ordinal event;
+        bool observe_only;
+        unsigned long long calls, over_budget, dropped;
+        double avg_us, max_us;
     };
 
     void run_events(event_ordinal k, Pose& pose);
+    // no enabled extension that can change the pose hooks any event.
+    // observe-only ones don't count.
+    bool empty() const;
+    std::vector<stats> get_stats() const;
+
     event_handler(Modules::dylib_list const& extensions);
+    ~event_handler();
 
 private:
+    struct observer_thread;
+
     using ext_list = std::vector<extension>;
+    // called from the pipeline thread, in the pose's path
     std::array<ext_list, IExtension::event_count> extensions_for_event;
+    // called from observer_thread with a copy
+    std::array<ext_list, IExtension::event_count> observers_for_event;
 
     options::bundle ext_bundle;
+    // longer calls are counted and logged
+    options::value<int> budget_usecs { ext_bundle, "time-budget-usecs", 500 };
+    long long budget_ns;
+
+    std::unique_ptr<observer_thread> observers;
 
     bool is_enabled(const QString& name);
+    void call(event_ordinal k, extension& x, Pose& pose);
 };
-
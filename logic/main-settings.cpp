@@ -43,7 +43,9 @@ main_settings::main_settings() :
     key_zero_press1(b, "zero-press"),
     key_zero_press2(b, "zero-press-alt"),
     tracklogging_enabled(b, "tracklogging-enabled", false),
-    tracklogging_filename(b, "tracklogging-filename", QString())
+    tracklogging_filename(b, "tracklogging-filename", QString()),
+    evdev_shortcuts(b, "evdev-shortcuts", false),
+    evdev_devices(b, "evdev-devices", QString())
 {
 }
 
@@ -66,6 +66,8 @@ struct OTR_LOGIC_EXPORT main_settings final
     key_opts key_zero_press1, key_zero_press2;
     value<bool> tracklogging_enabled;
     value<QString> tracklogging_filename;
+    value<bool> evdev_shortcuts;
+    value<QString> evdev_devices;
 
     main_settings();
 };
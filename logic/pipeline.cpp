@@ -15,12 +15,14 @@
 #include "compat/sleep.hpp"
 #include "compat/math.hpp"
 #include "compat/meta.hpp"
+#include "compat/thread-monitor.hpp"
 
 #include "pipeline.hpp"
 
 #include <cmath>
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 #ifdef _WIN32
 #   include <windows.h>
@@ -35,13 +37,13 @@ static constexpr inline double d2r = M_PI / 180.;
 
 reltrans::reltrans() {}
 
-euler_t reltrans::rotate(const rmat& R, const euler_t& in, vec3_bool disable) const
+euler_t reltrans::rotate(const quat& q, const euler_t& in, vec3_bool disable) const
 {
     enum { tb_Z, tb_X, tb_Y };
 
     // TY is really yaw axis. need swapping accordingly.
     // sign changes are due to right-vs-left handedness of coordinate system used
-    const euler_t ret = R * euler_t(in(TZ), -in(TX), -in(TY));
+    const euler_t ret = q.rotate(euler_t(in(TZ), -in(TX), -in(TY)));
 
     euler_t output;
 
@@ -63,7 +65,7 @@ euler_t reltrans::rotate(const rmat& R, const euler_t& in, vec3_bool disable) co
     return output;
 }
 
-Pose reltrans::apply_pipeline(reltrans_state state, const Pose& value, const vec6_bool& disable)
+Pose reltrans::apply_pipeline(reltrans_state state, const Pose& value, const vec6_bool& disable, const quat& rotation)
 {
     if (state != reltrans_disabled)
     {
@@ -95,11 +97,14 @@ Pose reltrans::apply_pipeline(reltrans_state state, const Pose& value, const vec
         // only when looking behind or downward
         if (in_zone)
         {
-            const rmat R = euler_to_rmat(euler_t(value(Yaw)   * d2r * !disable(Yaw),
-                                                 value(Pitch) * d2r * !disable(Pitch),
-                                                 value(Roll)  * d2r * !disable(Roll)));
-
-            rel = rotate(R, rel, &disable[TX]);
+            const bool any_disabled = disable(Yaw) || disable(Pitch) || disable(Roll);
+            const quat q = !any_disabled
+                           ? rotation
+                           : euler_to_quat(euler_t(value(Yaw)   * d2r * !disable(Yaw),
+                                                   value(Pitch) * d2r * !disable(Pitch),
+                                                   value(Roll)  * d2r * !disable(Roll)));
+
+            rel = rotate(q, rel, &disable[TX]);
         }
 
         if (cur)
@@ -142,7 +147,7 @@ Pose reltrans::apply_pipeline(reltrans_state state, const Pose& value, const vec
     }
 }
 
-euler_t reltrans::apply_neck(const Pose& value, bool enable, int nz) const
+euler_t reltrans::apply_neck(const quat& rotation, bool enable, int nz) const
 {
     if (!enable)
         return {};
@@ -151,8 +156,7 @@ euler_t reltrans::apply_neck(const Pose& value, bool enable, int nz) const
 
     if (nz != 0)
     {
-        const rmat R = euler_to_rmat(euler_t(&value[Yaw]) * d2r);
-        neck = rotate(R, { 0, 0, nz }, vec3_bool());
+        neck = rotate(rotation, { 0, 0, nz }, vec3_bool());
         neck(TZ) = neck(TZ) - nz;
     }
 
@@ -165,12 +169,32 @@ pipeline::pipeline(Mappings& m, runtime_libraries& libs, event_handler& ev, Trac
     libs(libs),
     logger(logger)
 {
+    const auto dirty = [this] { settings_changed.store(true, std::memory_order_relaxed); };
+
+    connect(s.b.get(), &options::bundle_::changed, this, dirty, Qt::DirectConnection);
+    connect(s.b_map.get(), &options::bundle_::changed, this, dirty, Qt::DirectConnection);
+
+    for (int i = 0; i < 6; i++)
+        for (spline* f : { &m(i).spline_main, &m(i).spline_alt })
+            connect(f->get_bundle().get(), &options::bundle_::changed, this, dirty, Qt::DirectConnection);
 }
 
+std::atomic<int> pipeline::running_count { 0 };
+
 pipeline::~pipeline()
 {
     requestInterruption();
     wait();
+
+    const skip_stats st = get_skip_stats();
+    if (st.ticks)
+        qDebug() << "pipeline:" << st.ticks << "ticks," << st.unchanged_samples << "unchanged samples,"
+                 << "mapping skipped" << st.mapping_skipped << "protocol skipped" << st.protocol_skipped;
+}
+
+static bool same_bits(const Pose& a, const Pose& b)
+{
+    return !std::memcmp(static_cast<const double*>(a), static_cast<const double*>(b), sizeof(double) * 6);
 }
 
 double pipeline::map(double pos, Map& axis)
@@ -268,8 +292,7 @@ void pipeline::maybe_enable_center_on_tracking_started()
 void pipeline::maybe_set_center_pose(const Pose& value, bool own_center_logic)
 {
     euler_t tmp = d2r * euler_t(&value[Yaw]);
-    scaled_rotation.rotation = euler_to_rmat(c_div * tmp);
-    real_rotation.rotation = euler_to_rmat(tmp);
+    scaled_rotation.rotation = euler_to_quat(c_div * tmp);
 
     if (get(f_center))
     {
@@ -278,15 +301,18 @@ void pipeline::maybe_set_center_pose(const Pose& value, bool own_center_logic)
 
         if (own_center_logic)
         {
-            scaled_rotation.rot_center = rmat::eye();
-            real_rotation.rot_center = rmat::eye();
+            scaled_rotation.rot_center = quat();
+            real_rotation.rot_center = quat();
 
             t_center = euler_t();
         }
         else
         {
-            real_rotation.rot_center = real_rotation.rotation.t();
-            scaled_rotation.rot_center = scaled_rotation.rotation.t();
+            // the unscaled rotation is only ever used for the center
+            real_rotation.rotation = euler_to_quat(tmp);
+
+            real_rotation.rot_center = real_rotation.rotation.conj();
+            scaled_rotation.rot_center = scaled_rotation.rotation.conj();
 
             t_center = euler_t(static_cast<const double*>(value));
         }
@@ -316,9 +342,9 @@ Pose pipeline::clamp_value(Pose value) const
 
 Pose pipeline::apply_center(Pose value) const
 {
-    rmat rotation = scaled_rotation.rotation * scaled_rotation.rot_center;
+    const quat rotation = scaled_rotation.rotation * scaled_rotation.rot_center;
     euler_t pos = euler_t(value) - t_center;
-    euler_t rot = r2d * c_mult * rmat_to_euler(rotation);
+    euler_t rot = r2d * c_mult * quat_to_euler(rotation);
 
     pos = rel.rotate(real_rotation.rot_center, pos, vec3_bool());
 
@@ -386,15 +412,24 @@ Pose pipeline::apply_zero_pos(Pose value) const
 
 Pose pipeline::apply_reltrans(Pose value, vec6_bool disabled)
 {
-    const euler_t neck = rel.apply_neck(value, s.neck_enable, -s.neck_z);
+    const bool neck_enable = s.neck_enable;
+    const reltrans_state mode = s.reltrans_mode;
 
-    value = rel.apply_pipeline(s.reltrans_mode, value,
+    // neck and reltrans both rotate by the same mapped pose
+    quat rotation;
+    if (neck_enable || mode != reltrans_disabled)
+        rotation = euler_to_quat(euler_t(&value[Yaw]) * d2r);
+
+    const euler_t neck = rel.apply_neck(rotation, neck_enable, -s.neck_z);
+
+    value = rel.apply_pipeline(mode, value,
                                { !!s.reltrans_disable_src_yaw,
                                  !!s.reltrans_disable_src_pitch,
                                  !!s.reltrans_disable_src_roll,
                                  !!s.reltrans_disable_tx,
                                  !!s.reltrans_disable_ty,
-                                 !!s.reltrans_disable_tz });
+                                 !!s.reltrans_disable_tz },
+                               rotation);
 
     for (int i = 0; i < 3; i++)
         value(i) += neck(i);
@@ -407,11 +442,92 @@ Pose pipeline::apply_reltrans(Pose value, vec6_bool disabled)
     return value;
 }
 
+void pipeline::maybe_swap_modules()
+{
+    if (!swap_pending.load(std::memory_order_acquire))
+        return;
+
+    QMutexLocker l(&swap_mtx);
+
+    // same as when tracking stops
+    if (protocol_swap && libs.pProtocol)
+    {
+        Pose p;
+        libs.pProtocol->pose(p);
+    }
+
+    swap_modules();
+}
+
+void pipeline::swap_modules()
+{
+    if (filter_swap)
+    {
+        std::swap(libs.pFilter, next_filter);
+        filter_swap = false;
+
+        if (libs.pFilter && have_last)
+        {
+            Pose tmp;
+            libs.pFilter->filter(last_filtered, tmp);
+        }
+    }
+
+    if (protocol_swap)
+    {
+        std::swap(libs.pProtocol, next_protocol);
+        protocol_swap = false;
+    }
+
+    // nothing reused from before applies to the new modules
+    have_last = false;
+    settings_changed.store(true, std::memory_order_relaxed);
+
+    swap_pending.store(false, std::memory_order_release);
+    swap_cond.wakeAll();
+}
+
+void pipeline::wait_for_swap()
+{
+    swap_pending.store(true, std::memory_order_release);
+
+    while (swap_pending.load(std::memory_order_acquire) && isRunning())
+        swap_cond.wait(&swap_mtx, 100);
+
+    // not started or already stopped, no tick to wait for
+    if (swap_pending.load(std::memory_order_acquire))
+        swap_modules();
+}
+
+std::shared_ptr<IFilter> pipeline::swap_filter(std::shared_ptr<IFilter> f)
+{
+    QMutexLocker l(&swap_mtx);
+
+    next_filter = std::move(f);
+    filter_swap = true;
+    wait_for_swap();
+
+    return std::move(next_filter);
+}
+
+std::shared_ptr<IProtocol> pipeline::swap_protocol(std::shared_ptr<IProtocol> p)
+{
+    QMutexLocker l(&swap_mtx);
+
+    next_protocol = std::move(p);
+    protocol_swap = true;
+    wait_for_swap();
+
+    return std::move(next_protocol);
+}
+
 void pipeline::logic()
 {
     using namespace euler;
     using EV = event_handler::event_ordinal;
 
+    maybe_swap_modules();
+
     logger.write_dt();
     logger.reset_dt();
 
@@ -419,8 +535,9 @@ void pipeline::logic()
     const bool center_ordered = get(f_center) && tracking_started;
     const bool own_center_logic = center_ordered && libs.pTracker->center();
 
-    Pose value, raw;
+    Pose value, raw, corrected, filtered;
     vec6_bool disabled;
+    bool unchanged;
 
     {
         Pose tmp;
@@ -436,38 +553,70 @@ void pipeline::logic()
     std::tie(raw, value, disabled) = get_selected_axis_value(newpose);
     logger.write_pose(raw); // raw
 
-    value = clamp_value(value);
+    n_ticks.fetch_add(1, std::memory_order_relaxed);
+
+    // extensions can do anything, including depend on time. observers
+    // don't see ev_before_mapping for the skipped ticks.
+    unchanged = have_last && !center_ordered && ev.empty() &&
+                !settings_changed.exchange(false, std::memory_order_relaxed) &&
+                same_bits(newpose, last_newpose);
+    last_newpose = newpose;
+
+    if (unchanged)
+        n_unchanged.fetch_add(1, std::memory_order_relaxed);
 
     {
         maybe_enable_center_on_tracking_started();
-        maybe_set_center_pose(value, own_center_logic);
-        value = apply_center(value);
+        if (unchanged)
+            value = last_corrected;
+        else
+        {
+            value = clamp_value(value);
+            maybe_set_center_pose(value, own_center_logic);
+            value = apply_center(value);
+        }
+        corrected = value;
         logger.write_pose(value); // "corrected" - after various transformations to account for camera position
     }
 
+    // filters converge over time, always run them
     {
         ev.run_events(EV::ev_before_filter, value);
         value = maybe_apply_filter(value);
         nan_check(value);
+        filtered = value;
         logger.write_pose(value); // "filtered"
     }
 
+    if (unchanged && same_bits(filtered, last_filtered) && !rel.interpolating())
     {
-        ev.run_events(EV::ev_before_mapping, value);
-        // CAVEAT rotation only, due to tcomp
-        for (int i = 3; i < 6; i++)
-            value(i) = map(value(i), m(i));
+        value = last_mapped;
+        n_mapping_skipped.fetch_add(1, std::memory_order_relaxed);
     }
+    else
+    {
+        {
+            ev.run_events(EV::ev_before_mapping, value);
+            // CAVEAT rotation only, due to tcomp
+            for (int i = 3; i < 6; i++)
+                value(i) = map(value(i), m(i));
+        }
 
-    value = apply_reltrans(value, disabled);
+        value = apply_reltrans(value, disabled);
 
-    {
-        // CAVEAT translation only, due to tcomp
-        for (int i = 0; i < 3; i++)
-            value(i) = map(value(i), m(i));
-        nan_check(value);
+        {
+            // CAVEAT translation only, due to tcomp
+            for (int i = 0; i < 3; i++)
+                value(i) = map(value(i), m(i));
+            nan_check(value);
+        }
     }
 
+    last_corrected = corrected;
+    last_filtered = filtered;
+    last_mapped = value;
+    have_last = true;
+
     goto ok;
 
 nan:
@@ -476,6 +625,8 @@ nan:
 
         value = output_pose;
         raw = raw_6dof;
+        corrected = filtered = value;
+        have_last = false;
 
         // for widget last value display
         for (int i = 0; i < 6; i++)
@@ -493,7 +644,14 @@ ok:
     value = apply_zero_pos(value);
 
     ev.run_events(EV::ev_finished, value);
-    libs.pProtocol->pose(value);
+
+    if (have_last && same_bits(value, last_sent) && !libs.pProtocol->repeat_unchanged_pose())
+        n_protocol_skipped.fetch_add(1, std::memory_order_relaxed);
+    else
+        libs.pProtocol->pose(value);
+    last_sent = value;
+
+    history_.push({ tracking_time.elapsed_seconds(), raw, corrected, filtered, value });
 
     QMutexLocker foo(&mtx);
     output_pose = value;
@@ -530,11 +688,18 @@ void pipeline::run()
 
     logger.reset_dt();
 
+    portable::sleep(int(start_delay_ms));
+    running_count++;
+
+    thread_monitor monitor("pipeline");
+
     t.start();
+    tracking_time.start();
 
     while (!isInterruptionRequested())
     {
         logic();
+        monitor.tick();
 
         constexpr ns const_sleep_ms(time_cast<ns>(ms(4)));
         const ns elapsed_nsecs = prog1(t.elapsed<ns>(), t.start());
@@ -548,6 +713,11 @@ void pipeline::run()
 
         backlog_time += ns(elapsed_nsecs - const_sleep_ms);
 
+        // with other seats' pipelines running, drop the ticks instead of
+        // running them back-to-back and taking the cores from the rest
+        if (backlog_time > const_sleep_ms && running_count > 1)
+            backlog_time = const_sleep_ms;
+
         const int sleep_time_ms = time_cast<ms>(clamp(const_sleep_ms - backlog_time,
                                                       ms::zero(), ms(10))).count();
 
@@ -560,6 +730,8 @@ void pipeline::run()
         portable::sleep(sleep_time_ms);
     }
 
+    running_count--;
+
     // filter may inhibit exact origin
     Pose p;
     libs.pProtocol->pose(p);
@@ -587,6 +759,16 @@ void pipeline::raw_and_mapped_pose(double* mapped, double* raw) const
     }
 }
 
+pipeline::skip_stats pipeline::get_skip_stats() const
+{
+    return {
+        n_ticks.load(std::memory_order_relaxed),
+        n_unchanged.load(std::memory_order_relaxed),
+        n_mapping_skipped.load(std::memory_order_relaxed),
+        n_protocol_skipped.load(std::memory_order_relaxed),
+    };
+}
+
 void pipeline::set_center() { set(f_center, true); }
 
 void pipeline::set_enabled(bool value) { set(f_enabled_h, value); }
@@ -14,6 +14,7 @@
 #include "api/plugin-support.hpp"
 #include "mappings.hpp"
 #include "compat/euler.hpp"
+#include "compat/quat.hpp"
 #include "runtime-libraries.hpp"
 #include "extensions.hpp"
 
@@ -21,9 +22,11 @@
 #include "main-settings.hpp"
 #include "options/options.hpp"
 #include "tracklogger.hpp"
+#include "pose-history.hpp"
 
 #include <QMutex>
 #include <QThread>
+#include <QWaitCondition>
 
 #include <atomic>
 #include <cmath>
@@ -34,6 +37,7 @@ namespace gui_tracker_impl {
 
 using rmat = euler::rmat;
 using euler_t = euler::euler_t;
+using quat = euler::quat;
 
 using vec6_bool = Mat<bool, 6, 1>;
 using vec3_bool = Mat<bool, 6, 1>;
@@ -49,13 +53,17 @@ public:
     reltrans();
 
     warn_result_unused
-    euler_t rotate(const rmat& rmat, const euler_t& in, vec3_bool disable) const;
+    euler_t rotate(const quat& q, const euler_t& in, vec3_bool disable) const;
 
+    // `rotation' is the pose's own rotation, shared with apply_neck()
     warn_result_unused
-    Pose apply_pipeline(reltrans_state cur, const Pose& value, const vec6_bool& disable);
+    Pose apply_pipeline(reltrans_state cur, const Pose& value, const vec6_bool& disable, const quat& rotation);
 
     warn_result_unused
-    euler_t apply_neck(const Pose& value, bool enable, int nz) const;
+    euler_t apply_neck(const quat& rotation, bool enable, int nz) const;
+
+    // output keeps moving on its own while this is true
+    bool interpolating() const { return cur; }
 };
 
 using namespace time_units;
@@ -86,23 +94,22 @@ private:
     Mappings& m;
     event_handler& ev;
 
-    Timer t;
+    Timer t, tracking_time;
     Pose output_pose, raw_6dof, last_mapped, last_raw;
 
     Pose newpose;
-    runtime_libraries const& libs;
+    runtime_libraries& libs;
     // The owner of the reference is the main window.
     // This design might be usefull if we decide later on to swap out
     // the logger while the tracker is running.
     TrackLogger& logger;
 
+    pose_history history_;
+
     struct state
     {
-        rmat rot_center;
-        rmat rotation;
-
-        state() : rot_center(rmat::eye())
-        {}
+        quat rot_center;
+        quat rotation;
     };
 
     reltrans rel;
@@ -111,9 +118,37 @@ private:
     euler_t t_center;
 
     ns backlog_time = ns(0);
+    unsigned start_delay_ms = 0;
+
+    // a late pipeline doesn't catch up in a burst while others run
+    static std::atomic<int> running_count;
 
     bool tracking_started = false;
 
+    // a tracker sample that's bitwise the same as last tick's, with no
+    // settings changed in between, gives the same output from every stage
+    // that doesn't depend on time. those are reused instead.
+    // last_mapped is above.
+    Pose last_newpose, last_corrected, last_filtered, last_sent;
+    bool have_last = false;
+    std::atomic<bool> settings_changed { true };
+    std::atomic<unsigned long long> n_ticks { 0 }, n_unchanged { 0 },
+                                    n_mapping_skipped { 0 }, n_protocol_skipped { 0 };
+
+    // modules handed in while running, put in place between two ticks.
+    // after the swap, next_* hold the old ones for the caller.
+    QMutex swap_mtx;
+    QWaitCondition swap_cond;
+    std::atomic<bool> swap_pending { false };
+    bool filter_swap = false, protocol_swap = false;
+    std::shared_ptr<IFilter> next_filter;
+    std::shared_ptr<IProtocol> next_protocol;
+
+    void maybe_swap_modules();
+    void swap_modules();
+    // with swap_mtx held
+    void wait_for_swap();
+
     double map(double pos, Map& axis);
     void logic();
     void run() override;
@@ -134,7 +169,22 @@ public:
     ~pipeline();
 
     void raw_and_mapped_pose(double* mapped, double* raw) const;
-    void start() { QThread::start(QThread::HighPriority); }
+
+    struct skip_stats final
+    {
+        unsigned long long ticks, unchanged_samples, mapping_skipped, protocol_skipped;
+    };
+    skip_stats get_skip_stats() const;
+    // safe to read from any thread
+    const pose_history& history() const { return history_; }
+    // replace the module without stopping tracking, and return the old one.
+    // the new one has to be initialized already. the filter starts from the
+    // last filtered pose, so the view doesn't jump.
+    std::shared_ptr<IFilter> swap_filter(std::shared_ptr<IFilter> f);
+    std::shared_ptr<IProtocol> swap_protocol(std::shared_ptr<IProtocol> p);
+
+    // the delay moves this pipeline's ticks relative to others'
+    void start(unsigned delay_ms = 0) { start_delay_ms = delay_ms; QThread::start(QThread::HighPriority); }
 
     void toggle_zero();
     void toggle_enabled();
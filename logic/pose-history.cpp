@@ -0,0 +1,82 @@
+#include "pose-history.hpp"
+
+#include <algorithm>
+
+pose_history::pose_history() : slots(new slot[capacity])
+{
+}
+
+pose_history::~pose_history() = default;
+
+void pose_history::push(const pose_sample& x)
+{
+    const unsigned long long n = head.load(std::memory_order_relaxed);
+    slot& s = slots[n % capacity];
+
+    s.seq.store(2*n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    s.values[0].store(x.t, std::memory_order_relaxed);
+    const Pose* poses[] = { &x.raw, &x.corrected, &x.filtered, &x.mapped };
+    for (unsigned k = 0; k < 4; k++)
+        for (unsigned i = 0; i < 6; i++)
+            s.values[1 + k*6 + i].store((*poses[k])(i), std::memory_order_relaxed);
+
+    s.seq.store(2*n + 2, std::memory_order_release);
+    head.store(n + 1, std::memory_order_release);
+}
+
+bool pose_history::read(unsigned long long n, pose_sample& out) const
+{
+    const slot& s = slots[n % capacity];
+
+    if (s.seq.load(std::memory_order_acquire) != 2*n + 2)
+        return false;
+
+    out.t = s.values[0].load(std::memory_order_relaxed);
+    Pose* poses[] = { &out.raw, &out.corrected, &out.filtered, &out.mapped };
+    for (unsigned k = 0; k < 4; k++)
+        for (unsigned i = 0; i < 6; i++)
+            (*poses[k])(i) = s.values[1 + k*6 + i].load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s.seq.load(std::memory_order_relaxed) == 2*n + 2;
+}
+
+bool pose_history::latest(pose_sample& out) const
+{
+    for (;;)
+    {
+        const unsigned long long h = head.load(std::memory_order_acquire);
+        if (h == 0)
+            return false;
+        // only fails if the writer lapped us, then there's a newer one
+        if (read(h - 1, out))
+            return true;
+    }
+}
+
+unsigned pose_history::snapshot(std::vector<pose_sample>& out, double max_age) const
+{
+    const unsigned long long h = head.load(std::memory_order_acquire);
+    const unsigned long long first = h > capacity ? h - capacity : 0;
+    const std::size_t start = out.size();
+
+    out.reserve(start + unsigned(h - first));
+
+    pose_sample x;
+
+    // newest first, to stop at max_age without reading the rest
+    for (unsigned long long n = h; n > first; n--)
+    {
+        if (!read(n - 1, x))
+            break; // the writer got this far back, the rest is newer still
+        if (out.size() > start && out[start].t - x.t > max_age)
+            break;
+        out.push_back(x);
+    }
+
+    std::reverse(out.begin() + start, out.end());
+
+    return unsigned(out.size() - start);
+}
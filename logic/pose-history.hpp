@@ -0,0 +1,55 @@
+#pragma once
+
+#include "api/plugin-api.hpp"
+#include "export.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct pose_sample final
+{
+    double t = 0; // seconds since tracking started
+    Pose raw, corrected, filtered, mapped;
+};
+
+// The last few seconds of pipeline output, for graphs and diagnostics that
+// want more than the latest pose. Storage is allocated once. There's one
+// writer, the pipeline thread, and it never waits for readers. Readers copy
+// out what they want and drop slots that were overwritten while copying.
+
+class OTR_LOGIC_EXPORT pose_history final
+{
+public:
+    // a bit over 8 seconds at the pipeline's 250 Hz
+    static constexpr inline unsigned capacity = 2048;
+
+    pose_history();
+    ~pose_history();
+
+    void push(const pose_sample& x);
+
+    // appends samples no older than `max_age' seconds before the latest
+    // one, oldest first. returns how many were appended.
+    unsigned snapshot(std::vector<pose_sample>& out, double max_age = 1e300) const;
+    bool latest(pose_sample& out) const;
+
+    pose_history(const pose_history&) = delete;
+    pose_history& operator=(const pose_history&) = delete;
+
+private:
+    static constexpr inline unsigned value_count = 1 + 4 * 6;
+
+    struct slot
+    {
+        // 2n+1 while sample n is written, 2n+2 after
+        std::atomic<unsigned long long> seq { 0 };
+        std::atomic<double> values[value_count] {};
+    };
+
+    bool read(unsigned long long n, pose_sample& out) const;
+
+    std::unique_ptr<slot[]> slots;
+    // samples pushed so far
+    std::atomic<unsigned long long> head { 0 };
+};
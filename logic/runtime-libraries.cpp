@@ -3,7 +3,7 @@
 #include <QMessageBox>
 #include <QDebug>
 
-runtime_libraries::runtime_libraries(QFrame* frame, dylibptr t, dylibptr p, dylibptr f)
+runtime_libraries::runtime_libraries(QFrame* frame, dylibptr t, dylibptr p, dylibptr f, bool interactive)
 {
     module_status status =
             module_status_mixin::error(otr_tr("Library load failure"));
@@ -56,7 +56,12 @@ end:
     pFilter = nullptr;
     pProtocol = nullptr;
 
-    if (!status.is_ok())
+    if (status.is_ok())
+        return;
+
+    if (interactive)
         QMessageBox::critical(nullptr, "Startup failure", status.error, QMessageBox::Cancel, QMessageBox::NoButton);
+    else
+        qDebug() << "startup failure:" << status.error;
 }
 
@@ -21,7 +21,8 @@ struct OTR_LOGIC_EXPORT runtime_libraries final
     std::shared_ptr<IFilter> pFilter;
     std::shared_ptr<IProtocol> pProtocol;
 
-    runtime_libraries(QFrame* frame, dylibptr t, dylibptr p, dylibptr f);
+    // when not interactive, report load errors to the log instead of a message box
+    runtime_libraries(QFrame* frame, dylibptr t, dylibptr p, dylibptr f, bool interactive = true);
     runtime_libraries() : pTracker(nullptr), pFilter(nullptr), pProtocol(nullptr), correct(false) {}
 
     bool correct = false;
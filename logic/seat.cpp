@@ -0,0 +1,60 @@
+#include "seat.hpp"
+#include "options/scoped.hpp"
+
+#include <QDebug>
+
+using dylib_ptr = std::shared_ptr<dylib>;
+
+static dylib_ptr find_module(Modules::dylib_list& list, const QString& name)
+{
+    for (dylib_ptr& lib : list)
+        if (lib->name == name)
+            return lib;
+    return nullptr;
+}
+
+seat::seat(Modules& modules, const QString& profile) : profile(profile)
+{
+    // everything below reads its settings from the seat's profile,
+    // including the modules' own
+    options::with_profile scope(profile);
+
+    s = std::make_unique<main_settings>();
+    mappings = std::make_unique<Mappings>(s->all_axis_opts);
+    ev = std::make_unique<event_handler>(modules.extensions());
+
+    const module_settings m;
+
+    const dylib_ptr t = find_module(modules.trackers(), m.tracker_dll);
+    const dylib_ptr p = find_module(modules.protocols(), m.protocol_dll);
+    const dylib_ptr f = find_module(modules.filters(), m.filter_dll);
+
+    if (!t || !p)
+    {
+        qDebug() << "seat" << profile << "tracker" << m.tracker_dll() << "or protocol" << m.protocol_dll() << "not found";
+        return;
+    }
+
+    // same argument order as Work
+    libs = runtime_libraries(&frame, t, p, f, false);
+
+    if (libs.correct)
+        tracker = std::make_unique<pipeline>(*mappings, libs, *ev, logger);
+}
+
+seat::~seat()
+{
+    // same order as Work
+    tracker = nullptr;
+    libs = runtime_libraries();
+}
+
+bool seat::is_ok() const
+{
+    return tracker != nullptr;
+}
+
+void seat::start(unsigned delay_ms)
+{
+    tracker->start(delay_ms);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "main-settings.hpp"
+#include "mappings.hpp"
+#include "extensions.hpp"
+#include "pipeline.hpp"
+#include "runtime-libraries.hpp"
+#include "tracklogger.hpp"
+#include "api/plugin-support.hpp"
+#include "export.hpp"
+
+#include <memory>
+
+#include <QFrame>
+#include <QString>
+
+// Another head tracked alongside the main one, for rigs with a few seats
+// in front of one machine. It has its own profile, extensions and pipeline,
+// and shares loaded modules and cameras with the rest of the process.
+// Nothing is shown for it; its profile is edited by switching to it in the
+// main window.
+
+struct OTR_LOGIC_EXPORT seat final
+{
+    seat(Modules& modules, const QString& profile);
+    ~seat();
+
+    bool is_ok() const;
+    void start(unsigned delay_ms);
+
+    const QString profile;
+
+private:
+    std::unique_ptr<main_settings> s;
+    std::unique_ptr<Mappings> mappings;
+    std::unique_ptr<event_handler> ev;
+    // trackers want somewhere to put their video
+    QFrame frame;
+    runtime_libraries libs;
+    TrackLogger logger;
+    std::unique_ptr<pipeline> tracker;
+};
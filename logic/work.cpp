@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QDebug>
 
 QString Work::browse_datalogging_file(main_settings &s)
 {
@@ -29,9 +30,21 @@ QString Work::browse_datalogging_file(main_settings &s)
     return newfilename;
 }
 
-std::shared_ptr<TrackLogger> Work::make_logger(main_settings &s)
+std::shared_ptr<TrackLogger> Work::make_logger(main_settings &s, bool interactive)
 {
-    if (s.tracklogging_enabled)
+    if (s.tracklogging_enabled && !interactive)
+    {
+        // can't ask for a filename, use the one from the profile
+        const QString filename = s.tracklogging_filename;
+        if (!filename.isEmpty())
+        {
+            auto logger = std::make_shared<TrackLoggerCSV>(filename);
+            if (logger->is_open())
+                return logger;
+            qDebug() << "unable to open tracklogging file" << filename;
+        }
+    }
+    else if (s.tracklogging_enabled)
     {
         QString filename = browse_datalogging_file(s);
         if (filename.isEmpty())
@@ -59,11 +72,11 @@ std::shared_ptr<TrackLogger> Work::make_logger(main_settings &s)
 }
 
 
-Work::Work(Mappings& m, event_handler& ev,  QFrame* frame, std::shared_ptr<dylib> tracker_, std::shared_ptr<dylib> filter_, std::shared_ptr<dylib> proto_) :
-    libs(frame, tracker_, filter_, proto_),
-    logger(make_logger(s)),
+Work::Work(Mappings& m, event_handler& ev,  QFrame* frame, std::shared_ptr<dylib> tracker_, std::shared_ptr<dylib> filter_, std::shared_ptr<dylib> proto_, bool interactive) :
+    libs(frame, tracker_, filter_, proto_, interactive),
+    logger(make_logger(s, interactive)),
     tracker(std::make_shared<pipeline>(m, libs, ev, *logger)),
-    sc(std::make_shared<Shortcuts>()),
+    sc(interactive ? std::make_shared<Shortcuts>() : nullptr),
     keys {
         key_tuple(s.key_center1, [&](bool) { tracker->set_center(); }, true),
         key_tuple(s.key_center2, [&](bool) { tracker->set_center(); }, true),
@@ -79,17 +92,148 @@ Work::Work(Mappings& m, event_handler& ev,  QFrame* frame, std::shared_ptr<dylib
 
         key_tuple(s.key_zero_press1, [&](bool x) { tracker->set_zero(x); }, false),
         key_tuple(s.key_zero_press2, [&](bool x) { tracker->set_zero(x); }, false),
-    }
+    },
+    interactive(interactive)
 {
     if (!is_ok())
         return;
+#ifdef __linux__
+    // doesn't need a display, so also for non-interactive mode
+    if (s.evdev_shortcuts)
+    {
+        evdev = std::make_unique<evdev_shortcuts>(s.evdev_devices);
+        if (!evdev->is_open())
+            evdev = nullptr;
+    }
+#endif
     reload_shortcuts();
     tracker->start();
 }
 
+void Work::start_seats(Modules& modules, const QStringList& profiles)
+{
+    const QString current = options::group::ini_filename();
+    const QStringList all = options::group::ini_list();
+
+    QStringList todo;
+    for (const QString& x : profiles)
+    {
+        if (x == current || todo.contains(x))
+            qDebug() << "seat" << x << "is already tracking";
+        else if (!all.contains(x))
+            qDebug() << "seat" << x << "has no profile";
+        else
+            todo.push_back(x);
+    }
+
+    // spread the pipelines' ticks over their 4 ms period, so that seats
+    // don't all wake up and compete for the cores at the same time
+    const unsigned n = unsigned(todo.size()) + 1;
+
+    for (const QString& x : todo)
+    {
+        auto ret = std::make_unique<seat>(modules, x);
+
+        if (!ret->is_ok())
+        {
+            qDebug() << "seat" << x << "failed to start";
+            continue;
+        }
+
+        ret->start(4 * unsigned(seats.size() + 1) / n);
+        qDebug() << "seat" << x << "tracking";
+        seats.push_back(std::move(ret));
+    }
+}
+
+QStringList Work::seat_profiles()
+{
+    return options::group::with_global_settings_object([](QSettings& s) {
+        return s.value(OPENTRACK_SEAT_PROFILES_KEY).toStringList();
+    });
+}
+
+static void report_swap_failure(const QString& error, bool interactive)
+{
+    if (interactive)
+        QMessageBox::critical(nullptr, otr_tr("Library load failure"), error, QMessageBox::Cancel, QMessageBox::NoButton);
+    else
+        qDebug() << "swap failure:" << error;
+}
+
+bool Work::swap_filter(std::shared_ptr<dylib> lib)
+{
+    // the old one's settings stay as they are
+    options::with_tracker_teardown sentinel;
+
+    // no instance means no filter
+    std::shared_ptr<IFilter> f = make_dylib_instance<IFilter>(lib);
+
+    if (f)
+    {
+        const module_status status = f->initialize();
+        if (!status.is_ok())
+        {
+            report_swap_failure(otr_tr("Error occured while loading filter %1\n\n%2\n")
+                                .arg(lib->name).arg(status.error), interactive);
+            return false;
+        }
+    }
+
+    // the old one goes away here, outside the pipeline thread
+    f = tracker->swap_filter(std::move(f));
+    f = nullptr;
+
+    return true;
+}
+
+bool Work::swap_protocol(std::shared_ptr<dylib> lib)
+{
+    options::with_tracker_teardown sentinel;
+
+    std::shared_ptr<IProtocol> p = make_dylib_instance<IProtocol>(lib);
+
+    if (!p)
+    {
+        report_swap_failure(otr_tr("Can't load protocol %1").arg(lib ? lib->name : QString()), interactive);
+        return false;
+    }
+
+    const module_status status = p->initialize();
+    if (!status.is_ok())
+    {
+        report_swap_failure(otr_tr("Error occured while loading protocol %1\n\n%2\n")
+                            .arg(lib->name).arg(status.error), interactive);
+        return false;
+    }
+
+    p = tracker->swap_protocol(std::move(p));
+    p = nullptr;
+
+    return true;
+}
+
 void Work::reload_shortcuts()
 {
-    sc->reload(keys);
+#ifdef __linux__
+    if (evdev)
+    {
+        evdev->reload(keys);
+        return;
+    }
+#endif
+    if (sc)
+        sc->reload(keys);
+}
+
+void Work::unload_shortcuts()
+{
+#ifdef __linux__
+    if (evdev)
+        evdev->reload({});
+#endif
+    if (sc)
+        sc->reload({});
 }
 
 bool Work::is_ok() const
@@ -100,7 +244,11 @@ bool Work::is_ok() const
 Work::~Work()
 {
     // order matters, otherwise use-after-free -sh
+    seats.clear();
     sc = nullptr;
+#ifdef __linux__
+    evdev = nullptr;
+#endif
     tracker = nullptr;
     libs = runtime_libraries();
 }
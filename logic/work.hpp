@@ -12,9 +12,11 @@
 #include "api/plugin-support.hpp"
 #include "pipeline.hpp"
 #include "shortcuts.h"
+#include "evdev-shortcuts.hpp"
 #include "export.hpp"
 #include "tracklogger.hpp"
 #include "logic/runtime-libraries.hpp"
+#include "seat.hpp"
 #include "api/plugin-support.hpp"
 
 #include <QObject>
@@ -33,14 +35,28 @@ struct OTR_LOGIC_EXPORT Work
     std::shared_ptr<TrackLogger> logger; // must come before tracker, since tracker depends on it
     std::shared_ptr<pipeline> tracker;
     std::shared_ptr<Shortcuts> sc;
+#ifdef __linux__
+    std::unique_ptr<evdev_shortcuts> evdev;
+#endif
     std::vector<key_tuple> keys;
+    // more heads tracked at the same time, each from its own profile
+    std::vector<std::unique_ptr<seat>> seats;
+    const bool interactive;
 
-    Work(Mappings& m, event_handler& ev, QFrame* frame, std::shared_ptr<dylib> tracker, std::shared_ptr<dylib> filter, std::shared_ptr<dylib> proto);
+    // non-interactive mode is for running without a display: no dialogs and no global shortcuts
+    Work(Mappings& m, event_handler& ev, QFrame* frame, std::shared_ptr<dylib> tracker, std::shared_ptr<dylib> filter, std::shared_ptr<dylib> proto, bool interactive = true);
     ~Work();
+    // seats that fail to start are logged and left out
+    void start_seats(Modules& modules, const QStringList& profiles);
+    static QStringList seat_profiles();
+    // while tracking. on failure, the old module stays.
+    bool swap_filter(std::shared_ptr<dylib> lib);
+    bool swap_protocol(std::shared_ptr<dylib> lib);
     void reload_shortcuts();
+    void unload_shortcuts();
     bool is_ok() const;
 
 private:
-    static std::shared_ptr<TrackLogger> make_logger(main_settings &s);
+    static std::shared_ptr<TrackLogger> make_logger(main_settings &s, bool interactive);
     static QString browse_datalogging_file(main_settings &s);
 };
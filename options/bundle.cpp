@@ -9,6 +9,8 @@
 #include "bundle.hpp"
 #include "value.hpp"
 
+#include <utility>
+
 #include <QThread>
 #include <QApplication>
 
@@ -19,10 +21,11 @@ namespace options
 
 namespace detail {
 
-bundle::bundle(const QString& group_name)
+bundle::bundle(const QString& group_name, const QString& ini_filename)
     : mtx(QMutex::Recursive),
       group_name(group_name),
-      saved(group_name),
+      ini_filename(ini_filename),
+      saved(group_name, ini_filename),
       transient(saved)
 {
 }
@@ -36,7 +39,7 @@ void bundle::reload()
     if (group_name.size())
     {
         QMutexLocker l(&mtx);
-        saved = group(group_name);
+        saved = group(group_name, ini_filename);
         const bool has_changes = is_modified();
         transient = saved;
 
@@ -142,7 +145,8 @@ void bundler::after_profile_changed_()
     {
         weak bundle = kv.second;
         shared bundle_ = bundle.lock();
-        if (bundle_)
+        // the ones bound to a profile stay with it
+        if (bundle_ && bundle_->profile().isEmpty())
         {
             //qDebug() << "bundle: reverting" << kv.first << "due to profile change";
             bundle_->reload();
@@ -164,10 +168,20 @@ bundler::~bundler()
     //qDebug() << "exit: bundle singleton";
 }
 
-std::shared_ptr<bundler::v> bundler::make_bundle(const bundler::k& key)
+static thread_local QString profile_for_new_bundles;
+
+QString set_profile_for_new_bundles(const QString& ini_filename)
+{
+    return std::exchange(profile_for_new_bundles, ini_filename);
+}
+
+std::shared_ptr<bundler::v> bundler::make_bundle(const bundler::k& name)
 {
     QMutexLocker l(&implsgl_mtx);
 
+    const QString& ini = profile_for_new_bundles;
+    const k key = ini.isEmpty() ? name : ini + QLatin1Char(':') + name;
+
     auto it = implsgl_data.find(key);
 
     if (it != implsgl_data.end())
@@ -179,7 +193,7 @@ std::shared_ptr<bundler::v> bundler::make_bundle(const bundler::k& key)
             qDebug() << "ERROR: nonexistent bundle" << key;
     }
 
-    auto shr = shared(new v(key), [this, key](v* ptr) {
+    auto shr = shared(new v(name, ini), [this, key](v* ptr) {
         QMutexLocker l(&implsgl_mtx);
 
         auto it = implsgl_data.find(key);
@@ -49,6 +49,8 @@ class OTR_OPTIONS_EXPORT bundle final : public QObject, public connector
 private:
     mutex mtx;
     const QString group_name;
+    // empty for the current profile
+    const QString ini_filename;
     group saved;
     group transient;
 
@@ -63,9 +65,10 @@ signals:
     void saving() const;
     void changed() const;
 public:
-    never_inline bundle(const QString& group_name);
+    never_inline bundle(const QString& group_name, const QString& ini_filename = QString());
     never_inline ~bundle() override;
     QString name() const { return group_name; }
+    QString profile() const { return ini_filename; }
     never_inline void store_kv(const QString& name, const QVariant& datum);
     never_inline bool contains(const QString& name) const;
     never_inline bool is_modified() const;
@@ -103,6 +106,9 @@ public:
 };
 
 OTR_OPTIONS_EXPORT bundler& singleton();
+
+// see options::with_profile. returns the previous value.
+OTR_OPTIONS_EXPORT QString set_profile_for_new_bundles(const QString& ini_filename);
 } // ns options::detail
 
 using bundle_ = detail::bundle;
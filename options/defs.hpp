@@ -3,5 +3,7 @@
 #include <QString>
 
 #define OPENTRACK_CONFIG_FILENAME_KEY "settings-filename"
+// profiles tracked alongside the current one, as more seats
+#define OPENTRACK_SEAT_PROFILES_KEY "seat-profiles"
 #define OPENTRACK_DEFAULT_CONFIG "default.ini"
 #define OPENTRACK_DEFAULT_CONFIG_Q QStringLiteral("default.ini")
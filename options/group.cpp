@@ -21,12 +21,12 @@
 
 namespace options {
 
-group::group(const QString& name) : name(name)
+group::group(const QString& name, const QString& ini_filename) : name(name), ini(ini_filename)
 {
     if (name == "")
         return;
 
-    with_settings_object([&](QSettings& conf) {
+    with_settings_object(ini, [&](QSettings& conf) {
         conf.beginGroup(name);
         for (auto& k_ : conf.childKeys())
         {
@@ -45,13 +45,16 @@ void group::save() const
     if (name == "")
         return;
 
-    with_settings_object([&](QSettings& s) {
+    with_settings_object(ini, [&](QSettings& s) {
         s.beginGroup(name);
         for (auto& i : kvs)
             s.setValue(i.first, i.second);
         s.endGroup();
 
-        mark_ini_modified();
+        if (ini.isEmpty())
+            mark_ini_modified();
+        else
+            s.sync();
     });
 }
 
@@ -126,6 +129,9 @@ QString group::ini_pathname()
 
 QString group::ini_combine(const QString& filename)
 {
+    // profiles outside the ini directory, e.g. for tools
+    if (QDir::isAbsolutePath(filename))
+        return filename;
     return ini_directory() + QStringLiteral("/") + filename;
 }
 
@@ -174,6 +180,21 @@ std::shared_ptr<QSettings> group::cur_settings_object()
     return cur_ini;
 }
 
+std::map<QString, std::shared_ptr<QSettings>> group::profile_inis;
+
+std::shared_ptr<QSettings> group::settings_object_for(const QString& filename)
+{
+    // same object as for the current profile, or writes through one
+    // would be lost when the other syncs
+    if (filename == ini_filename())
+        return cur_settings_object();
+
+    std::shared_ptr<QSettings>& ret = profile_inis[filename];
+    if (!ret)
+        ret = std::make_shared<QSettings>(ini_combine(filename), QSettings::IniFormat);
+    return ret;
+}
+
 std::shared_ptr<QSettings> group::cur_global_settings_object()
 {
     if (cur_global_ini)
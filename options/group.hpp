@@ -19,6 +19,8 @@ namespace options {
 class OTR_OPTIONS_EXPORT group final
 {
     QString name;
+    // empty for the current profile
+    QString ini;
 
     static QString cur_ini_pathname;
 
@@ -42,11 +44,13 @@ class OTR_OPTIONS_EXPORT group final
         never_inline saver_(QSettings& s, int& refcount, bool& modifiedp);
     };
     static std::shared_ptr<QSettings> cur_settings_object();
+    static std::shared_ptr<QSettings> settings_object_for(const QString& filename);
+    static std::map<QString, std::shared_ptr<QSettings>> profile_inis;
     static std::shared_ptr<QSettings> cur_global_settings_object();
 
 public:
     std::map<QString, QVariant> kvs;
-    group(const QString& name);
+    group(const QString& name, const QString& ini_filename = QString());
     void save() const;
     void put(const QString& s, const QVariant& d);
     bool contains(const QString& s) const;
@@ -79,6 +83,18 @@ public:
         return fun(saver.s);
     }
 
+    // for a profile other than the current one
+    template<typename F>
+    never_inline
+    static auto with_settings_object(const QString& filename, F&& fun)
+    {
+        if (filename.isEmpty())
+            return with_settings_object(fun);
+
+        QMutexLocker l(&cur_ini_mtx);
+        return fun(*settings_object_for(filename));
+    }
+
     template<typename F>
     static auto with_global_settings_object(F&& fun)
     {
@@ -69,4 +69,14 @@ with_tracker_teardown::~with_tracker_teardown()
     set_teardown_flag(old_value);
 }
 
+with_profile::with_profile(const QString& ini_filename) :
+    old_value(detail::set_profile_for_new_bundles(ini_filename))
+{
+}
+
+with_profile::~with_profile()
+{
+    detail::set_profile_for_new_bundles(old_value);
+}
+
 } // ns options
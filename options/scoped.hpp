@@ -19,6 +19,18 @@ private:
     bool old_value;
 };
 
+// settings made in this scope, on this thread, read and write the given
+// profile rather than the current one, and stay with it when the user
+// switches profiles
+struct OTR_OPTIONS_EXPORT with_profile final
+{
+    explicit with_profile(const QString& ini_filename);
+    ~with_profile();
+
+private:
+    QString old_value;
+};
+
 struct OTR_OPTIONS_EXPORT opts
 {
     template<typename t> using value = options::value<t>;
@@ -59,6 +59,8 @@ force_inline std::int32_t load(std::int32_t volatile& place)
 
 freetrack::freetrack()
 {
+    // don't parse the game list from the pose thread
+    CSV::preload();
 }
 
 freetrack::~freetrack()
@@ -20,6 +20,7 @@ public:
 
     module_status initialize() override;
     void pose(const double *headpose) final;
+    bool repeat_unchanged_pose() final { return false; }
     QString game_name() final;
 
 private:
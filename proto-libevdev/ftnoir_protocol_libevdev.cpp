@@ -7,22 +7,44 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <linux/input.h>
 
 #include <errno.h>
 #include <string.h>
 
 #include <algorithm>
+#include <cmath>
 
 #define CHECK_LIBEVDEV(expr) if ((error = (expr)) != 0) goto error;
 
-static const int max_input = 65535;
-static const int mid_input = 32767;
-static const int min_input = 0;
+static const int axes[] = {
+    /* translation goes first */
+    ABS_X, ABS_Y, ABS_Z, ABS_RX, ABS_RY, ABS_RZ
+};
 
-evdev::evdev() : dev(NULL), uidev(NULL)
+evdev::evdev() : dev(NULL), uidev(NULL), fd(-1)
 {
     int error = 0;
 
+    {
+        const int bits = clamp(int(s.resolution), 8, 31);
+
+        min_input = 0;
+        max_input = int((1ll << bits) - 1);
+        mid_input = max_input / 2;
+
+        const int ranges[] = {
+            s.range_x, s.range_y, s.range_z,
+            s.range_yaw, s.range_pitch, s.range_roll,
+        };
+
+        for (int i = 0; i < 6; i++)
+        {
+            scale[i] = mid_input / double(std::max(1, ranges[i]));
+            last_value[i] = mid_input;
+        }
+    }
+
     dev = libevdev_new();
 
     if (!dev)
@@ -42,12 +64,8 @@ evdev::evdev() : dev(NULL), uidev(NULL)
     absinfo.fuzz = 0;
 
     CHECK_LIBEVDEV(libevdev_enable_event_type(dev, EV_ABS));
-    CHECK_LIBEVDEV(libevdev_enable_event_code(dev, EV_ABS, ABS_X, &absinfo));
-    CHECK_LIBEVDEV(libevdev_enable_event_code(dev, EV_ABS, ABS_Y, &absinfo));
-    CHECK_LIBEVDEV(libevdev_enable_event_code(dev, EV_ABS, ABS_Z, &absinfo));
-    CHECK_LIBEVDEV(libevdev_enable_event_code(dev, EV_ABS, ABS_RX, &absinfo));
-    CHECK_LIBEVDEV(libevdev_enable_event_code(dev, EV_ABS, ABS_RY, &absinfo));
-    CHECK_LIBEVDEV(libevdev_enable_event_code(dev, EV_ABS, ABS_RZ, &absinfo));
+    for (int axis : axes)
+        CHECK_LIBEVDEV(libevdev_enable_event_code(dev, EV_ABS, axis, &absinfo));
 
     /* do not remove next 3 lines or udev scripts won't assign 0664 permissions -sh */
     CHECK_LIBEVDEV(libevdev_enable_event_type(dev, EV_KEY));
@@ -56,6 +74,8 @@ evdev::evdev() : dev(NULL), uidev(NULL)
 
     CHECK_LIBEVDEV(libevdev_uinput_create_from_device(dev, LIBEVDEV_UINPUT_OPEN_MANAGED, &uidev));
 
+    fd = libevdev_uinput_get_fd(uidev);
+
     return;
 error:
     if (uidev)
@@ -66,6 +86,7 @@ error:
         fprintf(stderr, "libevdev error: %d\n", error);
     uidev = NULL;
     dev = NULL;
+    fd = -1;
 }
 
 evdev::~evdev()
@@ -76,29 +97,48 @@ evdev::~evdev()
         libevdev_free(dev);
 }
 
-void evdev::pose(const double* headpose) {
-    static const int axes[] = {
-        /* translation goes first */
-        ABS_X, ABS_Y, ABS_Z, ABS_RX, ABS_RY, ABS_RZ
-    };
-
-    static const int max_value[] = {
-        100,
-        100,
-        100,
-        180,
-        90,
-        180
-    };
+void evdev::pose(const double* headpose)
+{
+    if (fd < 0)
+        return;
+
+    // six axes and the sync report, written out in a single syscall
+    struct input_event events[6 + 1];
+    unsigned cnt = 0;
 
     for (int i = 0; i < 6; i++)
     {
-        int value = headpose[i] * mid_input / max_value[i] + mid_input;
-        int normalized = clamp(value, min_input, max_input);
-        (void) libevdev_uinput_write_event(uidev, EV_ABS, axes[i], normalized);
+        const double value = headpose[i] * scale[i] + mid_input;
+        const int normalized = int(clamp(std::round(value), double(min_input), double(max_input)));
+
+        if (normalized == last_value[i])
+            continue;
+
+        last_value[i] = normalized;
+
+        struct input_event& ev = events[cnt++];
+        memset(&ev, 0, sizeof(ev));
+        ev.type = EV_ABS;
+        ev.code = axes[i];
+        ev.value = normalized;
     }
 
-    (void) libevdev_uinput_write_event(uidev, EV_SYN, SYN_REPORT, 0);
+    // nothing changed, don't wake up the readers
+    if (cnt == 0)
+        return;
+
+    struct input_event& syn = events[cnt++];
+    memset(&syn, 0, sizeof(syn));
+    syn.type = EV_SYN;
+    syn.code = SYN_REPORT;
+    syn.value = 0;
+
+    const size_t len = cnt * sizeof(*events);
+    ssize_t ret;
+
+    do
+        ret = write(fd, events, len);
+    while (ret < 0 && errno == EINTR);
 }
 
 module_status evdev::initialize()
@@ -9,11 +9,39 @@
 
 #include "compat/macros.hpp"
 #include "api/plugin-api.hpp"
+#include "options/options.hpp"
 #include <libevdev/libevdev.h>
 #include <libevdev/libevdev-uinput.h>
 
 #include <QMessageBox>
 
+using namespace options;
+
+enum evdev_resolution : int
+{
+    evdev_res_16bit = 16,
+    evdev_res_20bit = 20,
+    evdev_res_24bit = 24,
+    evdev_res_31bit = 31,
+};
+
+struct evdev_settings : opts
+{
+    value<evdev_resolution> resolution;
+    value<int> range_x, range_y, range_z, range_yaw, range_pitch, range_roll;
+
+    evdev_settings() :
+        opts("libevdev-proto"),
+        resolution(b, "axis-resolution", evdev_res_16bit),
+        range_x(b, "range-x", 100),
+        range_y(b, "range-y", 100),
+        range_z(b, "range-z", 100),
+        range_yaw(b, "range-yaw", 180),
+        range_pitch(b, "range-pitch", 90),
+        range_roll(b, "range-roll", 180)
+    {}
+};
+
 class evdev : public IProtocol
 {
 public:
@@ -23,6 +51,7 @@ public:
         return dev != NULL;
     }
     void pose(const double *headpose);
+    bool repeat_unchanged_pose() override { return false; }
     QString game_name() {
         return _("Virtual joystick for Linux");
     }
@@ -30,8 +59,18 @@ public:
     module_status initialize() override;
 
 private:
+    evdev_settings s;
+
     struct libevdev* dev;
     struct libevdev_uinput* uidev;
+    int fd;
+
+    // device range, fixed for the lifetime of the uinput node
+    int min_input, mid_input, max_input;
+    // axis units per degree or centimeter
+    double scale[6];
+    // last value written out, to skip unchanged axes
+    int last_value[6];
 };
 
 class LibevdevControls: public IProtocolDialog
@@ -44,6 +83,7 @@ public:
 
 private:
     Ui::UICLibevdevControls ui;
+    evdev_settings s;
     void save();
 
 private slots:
@@ -6,6 +6,19 @@ LibevdevControls::LibevdevControls()
 	ui.setupUi( this );
 	connect(ui.btnOK, SIGNAL(clicked()), this, SLOT(doOK()));
 	connect(ui.btnCancel, SIGNAL(clicked()), this, SLOT(doCancel()));
+
+	ui.resolution->addItem(tr("16 bits"), evdev_res_16bit);
+	ui.resolution->addItem(tr("20 bits"), evdev_res_20bit);
+	ui.resolution->addItem(tr("24 bits"), evdev_res_24bit);
+	ui.resolution->addItem(tr("31 bits"), evdev_res_31bit);
+
+	tie_setting(s.resolution, ui.resolution);
+	tie_setting(s.range_x, ui.range_x);
+	tie_setting(s.range_y, ui.range_y);
+	tie_setting(s.range_z, ui.range_z);
+	tie_setting(s.range_yaw, ui.range_yaw);
+	tie_setting(s.range_pitch, ui.range_pitch);
+	tie_setting(s.range_roll, ui.range_roll);
 }
 
 void LibevdevControls::doOK() {
@@ -14,8 +27,10 @@ void LibevdevControls::doOK() {
 }
 
 void LibevdevControls::doCancel() {
+    s.b->reload();
     close();
 }
 
 void LibevdevControls::save() {
+    s.b->save();
 }
@@ -21,6 +21,8 @@ public:
     mouse();
     module_status initialize() override { return status_ok(); }
     void pose( const double *headpose) override;
+    // the mouse moves by deltas, an unchanged pose moves it by nothing
+    bool repeat_unchanged_pose() override { return false; }
     QString game_name() override;
 
     int last_x, last_y;
@@ -46,6 +46,8 @@ public:
     ~vjoystick_proto() override;
     module_status initialize() override;
     void pose( const double *headpose ) override;
+    // the axes keep their last value
+    bool repeat_unchanged_pose() override { return false; }
     QString game_name() override { return otr_tr("Virtual joystick"); }
 private:
 };
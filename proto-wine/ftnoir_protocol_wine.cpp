@@ -17,6 +17,8 @@ wine::wine() : lck_shm(WINE_SHM_NAME, WINE_MTX_NAME, sizeof(WineSHM)), shm(NULL)
         shm = (WineSHM*) lck_shm.ptr();
         memset(shm, 0, sizeof(*shm));
     }
+    // don't parse the game list from the pose thread
+    CSV::preload();
     static const QString library_path(QCoreApplication::applicationDirPath() + OPENTRACK_LIBRARY_PATH);
     wrapper.setWorkingDirectory(QCoreApplication::applicationDirPath());
     wrapper.start("wine", QStringList() << (library_path + "opentrack-wrapper-wine.exe.so"));
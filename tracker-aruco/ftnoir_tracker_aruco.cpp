@@ -7,10 +7,12 @@
 
 #include "cv/video-widget.hpp"
 #include "ftnoir_tracker_aruco.h"
+#include "marker-id.hpp"
 #include "cv/video-property-page.hpp"
 #include "compat/camera-names.hpp"
 #include "compat/sleep.hpp"
 #include "compat/math-imports.hpp"
+#include "compat/thread-monitor.hpp"
 
 #ifdef _MSC_VER
 #   pragma warning(disable : 4702)
@@ -64,6 +66,7 @@ aruco_tracker::aruco_tracker()
     cv::setBreakOnError(true);
     // param 2 ignored for Otsu thresholding. it's required to use our fork of Aruco.
     set_detector_params();
+    detector.setMakerDetectorFunction(aruco_marker_id::identify);
 }
 
 aruco_tracker::~aruco_tracker()
@@ -72,7 +75,8 @@ aruco_tracker::~aruco_tracker()
     wait();
     // fast start/stop causes breakage
     portable::sleep(1000);
-    camera.release();
+    QMutexLocker l(&camera_mtx);
+    camera = nullptr;
 }
 
 module_status aruco_tracker::start_tracker(QFrame* videoframe)
@@ -162,16 +166,10 @@ bool aruco_tracker::open_camera()
 
     QMutexLocker l(&camera_mtx);
 
-    camera = cv::VideoCapture(camera_name_to_index(s.camera_name));
-    if (res.width)
-    {
-        camera.set(cv::CAP_PROP_FRAME_WIDTH, res.width);
-        camera.set(cv::CAP_PROP_FRAME_HEIGHT, res.height);
-    }
-    if (fps)
-        camera.set(cv::CAP_PROP_FPS, fps);
+    camera = video::subscribe({ camera_name_to_index(s.camera_name), fps, res.width, res.height,
+                                s.latest_frame, s.mjpeg_luma });
 
-    if (!camera.isOpened())
+    if (!camera)
     {
         qDebug() << "aruco tracker: can't open camera";
         return false;
@@ -220,6 +218,16 @@ void aruco_tracker::draw_ar(bool ok)
     ::snprintf(buf, sizeof(buf)-1, "Hz: %d", clamp(int(fps), 0, 9999));
     buf[sizeof(buf)-1] = '\0';
     cv::putText(frame, buf, cv::Point(10, 32), cv::FONT_HERSHEY_PLAIN, 2, cv::Scalar(0, 255, 0), 1);
+
+    char age[16];
+    ::snprintf(age, sizeof(age)-1, "Age: %d ms", clamp(int(frame_age_ms), 0, 9999));
+    age[sizeof(age)-1] = '\0';
+    cv::putText(frame, age, cv::Point(10, 64), cv::FONT_HERSHEY_PLAIN, 2, cv::Scalar(0, 255, 0), 1);
+
+    char busy[16];
+    ::snprintf(busy, sizeof(busy)-1, "Busy: %d%%", clamp(int(idle.get_stats().load * 100), 0, 100));
+    busy[sizeof(busy)-1] = '\0';
+    cv::putText(frame, busy, cv::Point(10, 96), cv::FONT_HERSHEY_PLAIN, 2, cv::Scalar(0, 255, 0), 1);
 }
 
 void aruco_tracker::clamp_last_roi()
@@ -379,21 +387,39 @@ void aruco_tracker::run()
 
     fps_timer.start();
     last_detection_timer.start();
+    idle.set_timeout(s.idle_timeout);
+
+    thread_monitor monitor("tracker-aruco");
 
     while (!isInterruptionRequested())
     {
         {
             QMutexLocker l(&camera_mtx);
 
-            if (!camera.read(color))
+            video::frame_ptr f = camera->next(100);
+            if (!f)
                 continue;
+            // shared with other trackers using this camera; never drawn on.
+            color = f->mat;
+            frame_age_ms = f->age_ms();
         }
 
-        cv::cvtColor(color, grayscale, cv::COLOR_BGR2GRAY);
+        // while idle, most frames are only checked for motion. this also
+        // keeps the thresholding params from cycling.
+        if (!idle.want_frame(color))
+            continue;
+
+        // luma-only capture is already what the detector wants; it only
+        // reads from it, so the shared buffer can be used as-is.
+        if (color.channels() == 1)
+            grayscale = color;
+        else
+            cv::cvtColor(color, grayscale, cv::COLOR_BGR2GRAY);
 
 #ifdef DEBUG_UNSHARP_MASKING
         {
             constexpr double strength = double(DEBUG_UNSHARP_MASKING);
+            grayscale = grayscale.clone();
             cv::GaussianBlur(grayscale, blurred, cv::Size(0, 0), gauss_kernel_size);
             cv::addWeighted(grayscale, 1 + strength, blurred, -strength, 0, grayscale);
             cv::imshow("capture", grayscale);
@@ -401,7 +427,10 @@ void aruco_tracker::run()
         }
 #endif
 
-        color.copyTo(frame);
+        if (color.channels() == 1)
+            cv::cvtColor(color, frame, cv::COLOR_GRAY2BGR);
+        else
+            color.copyTo(frame);
 
         set_intrinsics();
 
@@ -437,18 +466,28 @@ fail:
 
             const double dt = last_detection_timer.elapsed_seconds();
             last_detection_timer.start();
-            no_detection_timeout += dt;
-            if (no_detection_timeout > timeout)
+
+            // the gap since the last probe isn't time spent searching
+            if (!idle.is_idle())
             {
-                no_detection_timeout = 0;
-                cycle_detection_params();
+                no_detection_timeout += dt;
+                if (no_detection_timeout > timeout)
+                {
+                    no_detection_timeout = 0;
+                    cycle_detection_params();
+                }
             }
         }
 
+        if (idle.done(ok))
+            qDebug() << "aruco: reacquired after" << idle.get_stats().reacquire_ms << "ms";
+
         draw_ar(ok);
 
         if (frame.rows > 0)
             videoWidget->update_image(frame);
+
+        monitor.tick();
     }
 }
 
@@ -475,6 +514,9 @@ aruco_dialog::aruco_dialog() :
     tie_setting(s.camera_name, ui.cameraName);
     tie_setting(s.resolution, ui.resolution);
     tie_setting(s.force_fps, ui.cameraFPS);
+    tie_setting(s.latest_frame, ui.latest_frame);
+    tie_setting(s.mjpeg_luma, ui.mjpeg_luma);
+    tie_setting(s.idle_timeout, ui.idle_timeout);
     tie_setting(s.fov, ui.cameraFOV);
     tie_setting(s.headpos_x, ui.cx);
     tie_setting(s.headpos_y, ui.cy);
@@ -552,7 +594,8 @@ void aruco_dialog::camera_settings()
     if (tracker)
     {
         QMutexLocker l(&tracker->camera_mtx);
-        video_property_page::show_from_capture(tracker->camera, camera_name_to_index(s.camera_name));
+        if (tracker->camera)
+            tracker->camera->show_settings();
     }
     else
         video_property_page::show(camera_name_to_index(s.camera_name));
@@ -13,6 +13,8 @@
 #include "api/plugin-api.hpp"
 #include "cv/video-widget.hpp"
 #include "compat/timer.hpp"
+#include "video/capture-service.hpp"
+#include "cv/idle-gate.hpp"
 
 #include "include/markerdetector.h"
 
@@ -27,7 +29,6 @@
 #include <cinttypes>
 
 #include <opencv2/core.hpp>
-#include <opencv2/videoio.hpp>
 
 // value 0->1
 //#define DEBUG_UNSHARP_MASKING .75
@@ -50,6 +51,8 @@ struct settings : opts {
     value<QString> camera_name;
     value<int> force_fps, resolution;
     value<rot> model_rotation;
+    value<bool> latest_frame, mjpeg_luma;
+    value<int> idle_timeout;
     settings() :
         opts("aruco-tracker"),
         fov(b, "field-of-view", 56),
@@ -59,7 +62,10 @@ struct settings : opts {
         camera_name(b, "camera-name", ""),
         force_fps(b, "force-fps", 0),
         resolution(b, "force-resolution", 0),
-        model_rotation(b, "model-rotation", rot_zero)
+        model_rotation(b, "model-rotation", rot_zero),
+        latest_frame(b, "latest-frame", false),
+        mjpeg_luma(b, "mjpeg-luma-only", false),
+        idle_timeout(b, "idle-timeout", 0)
     {}
 };
 
@@ -95,13 +101,13 @@ private:
 
     cv::Point3f rotate_model(float x, float y, settings::rot mode);
 
-    cv::VideoCapture camera;
+    video::subscription_ptr camera;
     QMutex camera_mtx;
     QMutex mtx;
     std::unique_ptr<cv_video_widget> videoWidget;
     std::unique_ptr<QHBoxLayout> layout;
     settings s;
-    double pose[6] {}, fps = 0;
+    double pose[6] {}, fps = 0, frame_age_ms = 0;
     double no_detection_timeout = 0;
     cv::Mat frame, grayscale, color;
     cv::Matx33d r;
@@ -121,6 +127,7 @@ private:
     std::vector<cv::Point3f> roi_points {4};
     cv::Rect last_roi { 65535, 65535, 0, 0 };
     Timer fps_timer, last_detection_timer;
+    idle_gate idle;
     unsigned adaptive_size_pos = 0;
     bool use_otsu = false;
 
@@ -0,0 +1,181 @@
+#include "marker-id.hpp"
+#include "include/arucofidmarkers.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <unordered_map>
+
+namespace aruco_marker_id {
+
+namespace {
+
+// 7x7 cells, the outer ring black, 5x5 of data inside. each data row
+// carries two bits of the id as one of these words, first column first.
+constexpr unsigned grid = 5;
+constexpr unsigned cells = grid + 2;
+constexpr std::uint32_t words[4] = { 0x10, 0x17, 0x09, 0x0e };
+
+// bit (y*5 + x) is the cell at row y, column x
+using code = std::uint32_t;
+
+code make_code(unsigned id)
+{
+    code ret = 0;
+    for (unsigned y = 0; y < grid; y++)
+    {
+        const std::uint32_t w = words[(id >> (2 * (grid - 1 - y))) & 3];
+        for (unsigned x = 0; x < grid; x++)
+            if (w & (1u << (grid - 1 - x)))
+                ret |= code(1) << (y * grid + x);
+    }
+    return ret;
+}
+
+// same direction as FiducidalMarkers::rotate: out(i, j) = in(n-1-j, i)
+code rotate(code in)
+{
+    code ret = 0;
+    for (unsigned i = 0; i < grid; i++)
+        for (unsigned j = 0; j < grid; j++)
+            if (in & (code(1) << ((grid - 1 - j) * grid + i)))
+                ret |= code(1) << (i * grid + j);
+    return ret;
+}
+
+struct table final
+{
+    // (id << 2) | rotations
+    std::unordered_map<code, unsigned> codes;
+
+    table()
+    {
+        constexpr unsigned ids = 1 << (2 * grid);
+        codes.reserve(ids * 4);
+
+        for (unsigned id = 0; id < ids; id++)
+        {
+            // what the camera sees after the marker is rotated `rot' times
+            // less than upright. the stock detector rotates the bits until
+            // they read as a word and keeps the first rotation that does,
+            // so on a collision the fewer rotations win.
+            code c = make_code(id);
+            for (unsigned k = 0; k < 4; k++)
+            {
+                const unsigned rot = (4 - k) % 4;
+                auto [it, fresh] = codes.emplace(c, id << 2 | rot);
+                if (!fresh && (it->second & 3) > rot)
+                    it->second = id << 2 | rot;
+                c = rotate(c);
+            }
+        }
+    }
+};
+
+const table& get_table()
+{
+    static const table ret;
+    return ret;
+}
+
+// cv::threshold's THRESH_OTSU, without writing the thresholded image
+unsigned otsu(const unsigned char* data, int stride, int size)
+{
+    unsigned hist[256] {};
+
+    for (int y = 0; y < size; y++)
+    {
+        const unsigned char* row = data + y * stride;
+        for (int x = 0; x < size; x++)
+            hist[row[x]]++;
+    }
+
+    const double scale = 1. / (size * size);
+    double mu = 0;
+    for (unsigned i = 0; i < 256; i++)
+        mu += i * double(hist[i]);
+    mu *= scale;
+
+    double mu1 = 0, q1 = 0, max_sigma = 0;
+    unsigned ret = 0;
+
+    for (unsigned i = 0; i < 256; i++)
+    {
+        const double p_i = hist[i] * scale;
+        mu1 *= q1;
+        q1 += p_i;
+        const double q2 = 1 - q1;
+
+        if (std::min(q1, q2) < FLT_EPSILON || std::max(q1, q2) > 1 - FLT_EPSILON)
+            continue;
+
+        mu1 = (mu1 + i * p_i) / q1;
+        const double mu2 = (mu - q1 * mu1) / q2;
+        const double sigma = q1 * q2 * (mu1 - mu2) * (mu1 - mu2);
+        if (sigma > max_sigma)
+        {
+            max_sigma = sigma;
+            ret = i;
+        }
+    }
+
+    return ret;
+}
+
+} // ns
+
+int identify(const unsigned char* data, int stride, int size, int& rotations)
+{
+    const int w = size / int(cells);
+
+    if (w <= 0)
+        return -1;
+
+    const unsigned thres = otsu(data, stride, size);
+    const int half = w * w / 2;
+
+    // white if more than half the cell is above the threshold
+    auto is_white = [&](unsigned cx, unsigned cy) {
+        int n = 0;
+        for (int y = 0; y < w; y++)
+        {
+            const unsigned char* row = data + (int(cy) * w + y) * stride + int(cx) * w;
+            for (int x = 0; x < w; x++)
+                n += row[x] > thres;
+        }
+        return n > half;
+    };
+
+    for (unsigned y = 0; y < cells; y++)
+    {
+        const unsigned step = y == 0 || y == cells - 1 ? 1 : cells - 1;
+        for (unsigned x = 0; x < cells; x += step)
+            if (is_white(x, y))
+                return -1;
+    }
+
+    code c = 0;
+    for (unsigned y = 0; y < grid; y++)
+        for (unsigned x = 0; x < grid; x++)
+            if (is_white(x + 1, y + 1))
+                c |= code(1) << (y * grid + x);
+
+    const auto& codes = get_table().codes;
+    const auto it = codes.find(c);
+
+    if (it == codes.end())
+        return -1;
+
+    rotations = int(it->second & 3);
+    return int(it->second >> 2);
+}
+
+int identify(const cv::Mat& in, int& rotations)
+{
+    if (in.type() != CV_8UC1 || in.rows != in.cols)
+        return aruco::FiducidalMarkers::detect(in, rotations);
+
+    return identify(in.ptr(), int(in.step[0]), in.rows, rotations);
+}
+
+} // ns aruco_marker_id
@@ -0,0 +1,19 @@
+#pragma once
+
+// Drop-in for aruco::FiducidalMarkers::detect, installed with
+// MarkerDetector::setMakerDetectorFunction. Accepts the same markers with
+// the same rotation, but every 10-bit code in each of its four rotations
+// is precomputed, so identifying a candidate is a single lookup. Border
+// cells are tested first, most candidates stop there.
+
+#include <opencv2/core.hpp>
+
+namespace aruco_marker_id {
+
+// `in' is the warped candidate. returns the id, or -1.
+int identify(const cv::Mat& in, int& rotations);
+
+// same, on a square 8-bit image
+int identify(const unsigned char* data, int stride, int size, int& rotations);
+
+} // ns aruco_marker_id
@@ -8,13 +8,85 @@
 
 #include "fusion.h"
 #include "compat/library-path.hpp"
+#include "compat/quat.hpp"
+#include "compat/math.hpp"
+#include "compat/math-imports.hpp"
 
 #include <QDebug>
 #include <QMessageBox>
 #include <QApplication>
 
+#include <algorithm>
+
 static const QString own_name = QStringLiteral("fusion");
 
+namespace {
+
+using namespace euler;
+
+void interp_rotation(const double* a, const double* b, double t, double* out)
+{
+    static constexpr double d2r = M_PI / 180;
+
+    const quat qa = euler_to_quat({ a[Yaw] * d2r, a[Pitch] * d2r, a[Roll] * d2r });
+    const quat qb = euler_to_quat({ b[Yaw] * d2r, b[Pitch] * d2r, b[Roll] * d2r });
+    const euler_t ret = quat_to_euler(slerp(qa, qb, t));
+
+    for (unsigned k = 0; k < 3; k++)
+        out[Yaw + k] = ret(k) / d2r;
+}
+
+void interp_position(const double* a, const double* b, double t, double* out)
+{
+    for (unsigned k = TX; k <= TZ; k++)
+        out[k] = a[k] + (b[k] - a[k]) * t;
+}
+
+} // ns
+
+void fusion_source::update(const double* data, double time)
+{
+    if (nsamples > 0 && std::equal(data, data + 6, newest().data))
+        return;
+
+    if (nsamples > 0)
+    {
+        const double dt = time - newest().time;
+        // ignore dropouts when estimating the tracker's rate
+        if (dt < .5)
+            interval = nsamples == 1 ? dt : interval + (dt - interval) * .1;
+        head = (head + 1) % size;
+    }
+
+    std::copy(data, data + 6, ring[head].data);
+    ring[head].time = time;
+    nsamples++;
+}
+
+void fusion_source::bracket(double time, const double*& a, const double*& b, double& alpha) const
+{
+    const unsigned count = std::min(nsamples, size);
+    unsigned before = (head + size - (count - 1)) % size, after = before;
+
+    // newest to oldest, so the common case stops early
+    for (unsigned i = 0; i < count; i++)
+    {
+        const unsigned idx = (head + size - i) % size;
+        if (ring[idx].time <= time)
+        {
+            before = idx;
+            after = i == 0 ? idx : (idx + 1) % size;
+            break;
+        }
+    }
+
+    a = ring[before].data;
+    b = ring[after].data;
+
+    const double dt = ring[after].time - ring[before].time;
+    alpha = dt > 0 ? clamp((time - ring[before].time) / dt, 0., 1.) : 0;
+}
+
 static auto get_modules()
 {
     return Modules(OPENTRACK_BASE_PATH + OPENTRACK_LIBRARY_PATH);
@@ -22,6 +94,7 @@ static auto get_modules()
 
 fusion_tracker::fusion_tracker()
 {
+    interpolate = s.interpolate;
 }
 
 fusion_tracker::~fusion_tracker()
@@ -55,7 +128,6 @@ module_status fusion_tracker::start_tracker(QFrame* frame)
     QString err;
     module_status status;
 
-    fusion_settings s;
     const QString rot_tracker_name = s.rot_tracker_name().toString();
     const QString pos_tracker_name = s.pos_tracker_name().toString();
 
@@ -99,6 +171,12 @@ module_status fusion_tracker::start_tracker(QFrame* frame)
     rot_tracker = make_dylib_instance<ITracker>(rot_dylib);
     pos_tracker = make_dylib_instance<ITracker>(pos_dylib);
 
+    if (!rot_tracker || !pos_tracker)
+    {
+        err = tr("Can't load trackers.");
+        goto end;
+    }
+
     status = pos_tracker->start_tracker(frame);
 
     if (!status.is_ok())
@@ -145,13 +223,46 @@ void fusion_tracker::data(double *data)
         rot_tracker->data(rot_tracker_data);
         pos_tracker->data(pos_tracker_data);
 
-        for (unsigned k = 0; k < 3; k++)
-            data[k] = pos_tracker_data[k];
-        for (unsigned k = 3; k < 6; k++)
-            data[k] = rot_tracker_data[k];
+        const double now = t.elapsed_seconds();
+
+        rot_source.update(rot_tracker_data, now);
+        pos_source.update(pos_tracker_data, now);
+
+        rot_age.store(now - rot_source.newest().time, std::memory_order_relaxed);
+        pos_age.store(now - pos_source.newest().time, std::memory_order_relaxed);
+
+        if (!interpolate)
+        {
+            for (unsigned k = 0; k < 3; k++)
+                data[k] = pos_tracker_data[k];
+            for (unsigned k = 3; k < 6; k++)
+                data[k] = rot_tracker_data[k];
+        }
+        else
+        {
+            // both trackers are resampled at the same point in the past,
+            // one frame of the slower tracker behind, so that there's a
+            // sample on either side of it in both histories
+            const double when = now - std::max(rot_source.interval, pos_source.interval);
+
+            const double *a, *b;
+            double alpha;
+
+            pos_source.bracket(when, a, b, alpha);
+            interp_position(a, b, alpha, data);
+
+            rot_source.bracket(when, a, b, alpha);
+            interp_rotation(a, b, alpha, data);
+        }
     }
 }
 
+void fusion_tracker::sample_age(double& rot, double& pos) const
+{
+    rot = rot_age.load(std::memory_order_relaxed);
+    pos = pos_age.load(std::memory_order_relaxed);
+}
+
 fusion_dialog::fusion_dialog()
 {
     ui.setupUi(this);
@@ -178,6 +289,38 @@ fusion_dialog::fusion_dialog()
 
     tie_setting(s.rot_tracker_name, ui.rot_tracker);
     tie_setting(s.pos_tracker_name, ui.pos_tracker);
+    tie_setting(s.interpolate, ui.interpolate);
+
+    connect(&age_timer, &QTimer::timeout, this, &fusion_dialog::update_sample_age);
+}
+
+void fusion_dialog::register_tracker(ITracker* t)
+{
+    tracker = static_cast<fusion_tracker*>(t);
+    age_timer.start(250);
+}
+
+void fusion_dialog::unregister_tracker()
+{
+    age_timer.stop();
+    tracker = nullptr;
+    ui.sample_age->setText(QStringLiteral("-"));
+}
+
+void fusion_dialog::update_sample_age()
+{
+    if (!tracker)
+        return;
+
+    double rot, pos;
+    tracker->sample_age(rot, pos);
+
+    if (rot < 0 || pos < 0)
+        return;
+
+    ui.sample_age->setText(tr("rotation %1 ms, position %2 ms")
+                           .arg(rot * 1000, 0, 'f', 1)
+                           .arg(pos * 1000, 0, 'f', 1));
 }
 
 void fusion_dialog::doOK()
@@ -206,7 +349,8 @@ void fusion_dialog::doCancel()
 fusion_settings::fusion_settings() :
     opts("fusion-tracker"),
     rot_tracker_name(b, "rot-tracker", ""),
-    pos_tracker_name(b, "pos-tracker", "")
+    pos_tracker_name(b, "pos-tracker", ""),
+    interpolate(b, "interpolate", false)
 {
 }
 
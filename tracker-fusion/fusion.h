@@ -1,26 +1,67 @@
 #pragma once
 #include "api/plugin-api.hpp"
 #include "api/plugin-support.hpp"
+#include "compat/timer.hpp"
 #include <QObject>
 #include <QFrame>
+#include <QTimer>
 #include <QCoreApplication>
 
+#include <atomic>
+
 #include "options/options.hpp"
 using namespace options;
 
 struct fusion_settings final : opts
 {
     value<QVariant> rot_tracker_name, pos_tracker_name;
+    value<bool> interpolate;
 
     fusion_settings();
 };
 
+// Recent distinct samples from one tracker, timestamped as they arrive.
+// Trackers don't report time on their own so a sample is "new" when it
+// differs from the previous one.
+struct fusion_source final
+{
+    // enough for ~128 ms of a tracker running at the pipeline's rate
+    static constexpr unsigned size = 32;
+
+    struct sample final
+    {
+        double data[6] {};
+        double time = 0;
+    };
+
+    sample ring[size] {};
+    // index of the newest sample
+    unsigned head = 0;
+    unsigned nsamples = 0;
+    // smoothed time between samples, in seconds
+    double interval = 0;
+
+    void update(const double* data, double time);
+    const sample& newest() const { return ring[head]; }
+    // the samples on either side of `time', and how far between them it
+    // is. before the oldest or after the newest sample, both are that one.
+    void bracket(double time, const double*& a, const double*& b, double& alpha) const;
+};
+
 class fusion_tracker : public QObject, public ITracker
 {
     Q_OBJECT
 
     double rot_tracker_data[6] {}, pos_tracker_data[6] {};
 
+    fusion_settings s;
+    Timer t;
+    fusion_source rot_source, pos_source;
+    bool interpolate = false;
+
+    // for display in the dialog, in seconds
+    std::atomic<double> rot_age { -1 }, pos_age { -1 };
+
     std::unique_ptr<QFrame> other_frame;
     std::shared_ptr<dylib> rot_dylib, pos_dylib;
     std::shared_ptr<ITracker> rot_tracker, pos_tracker;
@@ -31,6 +72,8 @@ public:
     module_status start_tracker(QFrame*) override;
     void data(double* data) override;
 
+    void sample_age(double& rot, double& pos) const;
+
     static const QString& caption();
 };
 
@@ -42,11 +85,16 @@ class fusion_dialog : public ITrackerDialog
 
     fusion_settings s;
     Ui::fusion_ui ui;
+    fusion_tracker* tracker = nullptr;
+    QTimer age_timer;
 public:
     fusion_dialog();
+    void register_tracker(ITracker* t) override;
+    void unregister_tracker() override;
 private slots:
     void doOK();
     void doCancel();
+    void update_sample_age();
 };
 
 class fusion_metadata : public Metadata
@@ -0,0 +1,78 @@
+#include "diag-writer.hpp"
+#include "compat/base-path.hpp"
+
+#include <utility>
+
+#include <QFile>
+#include <QTime>
+#include <QMutexLocker>
+#include <QDebug>
+
+hatire_diag_writer::~hatire_diag_writer()
+{
+    {
+        QMutexLocker l(&mtx);
+        stop = true;
+        cond.wakeAll();
+    }
+    wait();
+}
+
+void hatire_diag_writer::write(const QString& message)
+{
+    const QTime now = QTime::currentTime();
+
+    QMutexLocker l(&mtx);
+
+    if (stop || failed)
+        return;
+
+    pending.append(now.toString("hh:mm:ss.zzz").toLatin1());
+    pending.append(": ");
+    pending.append(message.toUtf8());
+    pending.append("\r\n");
+
+    if (!isRunning())
+        start(QThread::LowPriority);
+    else if (pending.size() >= high_water_mark)
+        cond.wakeAll();
+}
+
+void hatire_diag_writer::run()
+{
+    QFile file(OPENTRACK_BASE_PATH + "/HATDiagnostics.txt");
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        qDebug() << "hatire: can't open" << file.fileName() << file.errorString();
+        QMutexLocker l(&mtx);
+        failed = true;
+        pending.clear();
+        return;
+    }
+
+    QByteArray buf;
+
+    for (;;)
+    {
+        bool done;
+
+        {
+            QMutexLocker l(&mtx);
+            if (!stop && pending.size() < high_water_mark)
+                cond.wait(&mtx, flush_interval_ms);
+            std::swap(buf, pending);
+            done = stop;
+        }
+
+        if (!buf.isEmpty())
+        {
+            file.write(buf);
+            file.flush();
+            buf.clear();
+        }
+
+        if (done)
+            break;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QByteArray>
+#include <QString>
+
+// Appends timestamped lines to HATDiagnostics.txt from a background
+// thread. Callers only format into a memory buffer; the file stays open
+// and is written in batches.
+
+class hatire_diag_writer final : public QThread
+{
+    QMutex mtx;
+    QWaitCondition cond;
+    QByteArray pending;
+    bool stop = false;
+    // the file couldn't be opened, drop messages from now on
+    bool failed = false;
+
+    void run() override;
+
+    static constexpr inline int flush_interval_ms = 250;
+    // past this, wake the writer early rather than wait for the interval
+    static constexpr inline int high_water_mark = 1 << 16;
+
+public:
+    hatire_diag_writer() = default;
+    ~hatire_diag_writer() override;
+
+    void write(const QString& message);
+};
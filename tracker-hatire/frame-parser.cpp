@@ -0,0 +1,107 @@
+#include "frame-parser.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static constexpr std::uint8_t header_byte = 0xAA, footer_byte = 0x55;
+
+void hatire_frame_parser::push(const char* data, unsigned len)
+{
+    if (len > capacity)
+    {
+        data += len - capacity;
+        len = capacity;
+    }
+
+    if (size() + len > capacity)
+    {
+        skip(size() + len - capacity);
+        errors++;
+    }
+
+    const unsigned pos = tail % capacity;
+    const unsigned n = std::min(len, capacity - pos);
+
+    std::memcpy(ring + pos, data, n);
+    std::memcpy(ring, data + n, len - n);
+
+    tail += len;
+}
+
+void hatire_frame_parser::clear()
+{
+    head = tail = 0;
+    in_sync = true;
+}
+
+unsigned hatire_frame_parser::take_errors()
+{
+    unsigned ret = errors;
+    errors = 0;
+    return ret;
+}
+
+bool hatire_frame_parser::decode(TArduinoData& out, bool big_endian) const
+{
+    if (at(frame_size - 2) != footer_byte || at(frame_size - 1) != footer_byte)
+        return false;
+
+    auto u16 = [&](unsigned i) -> quint16 {
+        const unsigned a = at(i), b = at(i + 1);
+        return quint16(big_endian ? a << 8 | b : b << 8 | a);
+    };
+
+    auto f32 = [&](unsigned i) -> float {
+        std::uint32_t x = 0;
+        for (unsigned k = 0; k < 4; k++)
+        {
+            const unsigned shift = big_endian ? 24 - 8 * k : 8 * k;
+            x |= std::uint32_t(at(i + k)) << shift;
+        }
+        float ret;
+        std::memcpy(&ret, &x, sizeof(ret));
+        return ret;
+    };
+
+    out.Begin = u16(0);
+    out.Code = u16(2);
+    for (unsigned k = 0; k < 3; k++)
+        out.Rot[k] = f32(4 + 4 * k);
+    for (unsigned k = 0; k < 3; k++)
+        out.Trans[k] = f32(16 + 4 * k);
+    out.End = u16(28);
+
+    for (unsigned k = 0; k < 3; k++)
+        if (!std::isfinite(out.Rot[k]) || !std::isfinite(out.Trans[k]))
+            return false;
+
+    return true;
+}
+
+bool hatire_frame_parser::next(TArduinoData& out, bool big_endian)
+{
+    while (size() >= frame_size)
+    {
+        if (at(0) == header_byte && at(1) == header_byte && decode(out, big_endian))
+        {
+            skip(frame_size);
+            in_sync = true;
+            return true;
+        }
+
+        // count each lost stretch once, not every byte of it
+        if (in_sync)
+            errors++;
+        in_sync = false;
+
+        // resync on the next header
+        unsigned i = 1;
+        const unsigned sz = size();
+        while (i + 1 < sz && !(at(i) == header_byte && at(i + 1) == header_byte))
+            i++;
+        skip(i);
+    }
+
+    return false;
+}
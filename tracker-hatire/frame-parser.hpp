@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ftnoir_arduino_type.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size byte ring fed from the serial port. Frames are decoded in
+// place, without copying the stream or allocating. Garbage between frames
+// is skipped by looking for the next 0xAAAA header.
+
+class hatire_frame_parser final
+{
+public:
+    static constexpr inline unsigned frame_size = sizeof(TArduinoData);
+    static constexpr inline unsigned capacity = 4096;
+
+    // if the consumer falls behind, the oldest bytes are dropped.
+    void push(const char* data, unsigned len);
+    // false when no complete frame is buffered.
+    bool next(TArduinoData& out, bool big_endian);
+    void clear();
+
+    // resyncs since the last call, each one being a run of skipped bytes
+    // or a frame that failed validation.
+    unsigned take_errors();
+    unsigned size() const { return unsigned(tail - head); }
+
+private:
+    std::uint8_t at(unsigned i) const { return ring[(head + i) % capacity]; }
+    void skip(unsigned n) { head += n; }
+    bool decode(TArduinoData& out, bool big_endian) const;
+
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+    std::uint8_t ring[capacity] {};
+    // free-running; only differences and `% capacity' are used.
+    unsigned head = 0, tail = 0;
+    unsigned errors = 0;
+    bool in_sync = true;
+};
@@ -21,11 +21,6 @@ hatire::hatire()
         HAT.Trans[0]=0;
         HAT.Trans[1]=0;
         HAT.Trans[2]=0;
-
-        Begin.append((unsigned char) 0xAA);
-        Begin.append((unsigned char) 0xAA);
-        End.append((unsigned char) 0x55);
-        End.append((unsigned char) 0x55);
 }
 
 hatire::~hatire()
@@ -85,42 +80,17 @@ void hatire::data(double *data)
     {
         QMutexLocker l(&t.data_mtx);
 
-        QByteArray& data_read = t.send_data_read_nolock();
+        hatire_frame_parser& parser = t.parser_nolock();
 
-        while (data_read.length() >= 30)
+        while (parser.next(ArduinoData, s.BigEndian))
         {
-            //t.Log(data_read.toHex());
-            // .Begin==0xAAAA .End==0x5555
-            if (data_read[0] == Begin[0] && data_read[1] == Begin[1] &&
-                data_read[28] == End[0] && data_read[29] == End[1])
-            {
-                QDataStream stream(&data_read, QIODevice::ReadOnly);
-
-                if (s.BigEndian)
-                    stream.setByteOrder(QDataStream::BigEndian);
-                else
-                    stream.setByteOrder(QDataStream::LittleEndian);
-
-                stream >> ArduinoData;
-
-                frame_cnt++;
-
-                if (ArduinoData.Code <= 1000)
-                    HAT = ArduinoData;
-
-                data_read.remove(0, 30);
-            }
-            else
-            {
-                CptError++;
-                // resync frame
-                const int index = data_read.indexOf(Begin, 1);
-                if (index == -1)
-                    data_read.clear();
-                else
-                    data_read.remove(0, index);
-            }
+            frame_cnt++;
+
+            if (ArduinoData.Code <= 1000)
+                HAT = ArduinoData;
         }
+
+        CptError += parser.take_errors();
     }
 
     if (CptError > 50)
@@ -34,8 +34,6 @@ public:
     hatire_thread t;
 private:
     TArduinoData ArduinoData, HAT;
-    QByteArray Begin;
-    QByteArray End;
 
     TrackerSettings s;
 
@@ -1,9 +1,7 @@
 #include "thread.hpp"
 #include "compat/sleep.hpp"
-#include "compat/base-path.hpp"
 #include <utility>
 
-#include <QTextStream>
 #include <QTime>
 #include <QDebug>
 
@@ -49,31 +47,11 @@ void hatire_thread::sendcmd_impl(const QByteArray &cmd)
 #endif
 }
 
-struct Diag final : public QFile
-{
-    Diag()
-    {
-        setFileName(OPENTRACK_BASE_PATH + "/HATDiagnostics.txt");
-    }
-};
-
 void hatire_thread::Log(const QString& message)
 {
-    // Drop out immediately if logging is off. Yes, there is still some overhead because of passing strings around for no reason.
-    // that's unfortunate and I'll monitor the impact and see if it needs a more involved fix.
     if (!s.EnableLogging) return;
 
-    Diag flDiagnostics;
-
-    if (flDiagnostics.open(QIODevice::ReadWrite | QIODevice::Append))
-    {
-        QTextStream out(&flDiagnostics);
-        QString milliSeconds;
-        milliSeconds = QString("%1").arg(QTime::currentTime().msec(), 3, 10, QChar('0'));
-        // We have a file
-        out << QTime::currentTime().toString() << "." << milliSeconds << ": " << message << "\r\n";
-        flDiagnostics.close();
-    }
+    diag.write(message);
 }
 
 void hatire_thread::start()
@@ -170,6 +148,10 @@ serial_result hatire_thread::init_serial_port_impl()
            )
         {
             Log(tr("Port Parameters set"));
+            {
+                QMutexLocker l(&data_mtx);
+                parser.clear();
+            }
             qDebug()  << QTime::currentTime()
                       << " HAT OPEN on"
                       << com_port.portName()
@@ -309,7 +291,7 @@ void hatire_thread::on_serial_read()
         timer.start();
 
         QMutexLocker lck(&data_mtx);
-        data_read.append(buf, sz);
+        parser.push(buf, unsigned(sz));
     }
 #if defined HATIRE_DEBUG_LOGFILE
     else
@@ -335,7 +317,7 @@ void hatire_thread::on_serial_read()
     }
 }
 
-QByteArray& hatire_thread::send_data_read_nolock()
+hatire_frame_parser& hatire_thread::parser_nolock()
 {
-    return data_read;
+    return parser;
 }
@@ -2,6 +2,8 @@
 
 #include "ftnoir_arduino_type.h"
 #include "ftnoir_tracker_hat_settings.h"
+#include "frame-parser.hpp"
+#include "diag-writer.hpp"
 
 #include <QSerialPort>
 #include <QByteArray>
@@ -48,7 +50,8 @@ class hatire_thread : public QThread
     using serial_t = QSerialPort;
 #endif
 
-    QByteArray data_read;
+    hatire_frame_parser parser;
+    hatire_diag_writer diag;
     serial_t com_port;
     TrackerSettings s;
     variance stat;
@@ -82,7 +85,7 @@ public:
     ~hatire_thread() override;
     hatire_thread();
 
-    QByteArray& send_data_read_nolock();
+    hatire_frame_parser& parser_nolock();
 
     void Log(const QString& message);
 
@@ -9,6 +9,7 @@
 #include "ftnoir_tracker_pt.h"
 #include "compat/camera-names.hpp"
 #include "compat/math-imports.hpp"
+#include "compat/thread-monitor.hpp"
 
 #include "pt-api.hpp"
 
@@ -57,6 +58,8 @@ void Tracker_PT::run()
     QTextStream log_stream(&log_file);
 #endif
 
+    thread_monitor monitor("tracker-pt");
+
     while(!isInterruptionRequested())
     {
         pt_camera_info info;
@@ -89,6 +92,13 @@ void Tracker_PT::run()
                 ever_success = true;
             }
 
+            {
+                QMutexLocker l(&camera_mtx);
+                if (camera->frame_done(success))
+                    qDebug() << "pt: reacquired after"
+                             << camera->get_idle_stats().reacquire_ms << "ms";
+            }
+
             {
                 Affine X_CM;
                 {
@@ -115,6 +125,8 @@ void Tracker_PT::run()
                     preview_frame = traits->make_preview(w, h);
                 }
             }
+
+            monitor.tick();
         }
     }
     qDebug() << "pt: thread stopped";
@@ -228,4 +240,10 @@ bool Tracker_PT::get_cam_info(pt_camera_info* info)
     return ret;
 }
 
+idle_gate::stats Tracker_PT::get_idle_stats()
+{
+    QMutexLocker lock(&camera_mtx);
+    return camera->get_idle_stats();
+}
+
 
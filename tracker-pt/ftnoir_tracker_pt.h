@@ -52,6 +52,7 @@ public:
     Affine pose();
     int  get_n_points();
     bool get_cam_info(pt_camera_info* info);
+    idle_gate::stats get_idle_stats();
 public slots:
     bool maybe_reopen_camera();
     void set_fov(int value);
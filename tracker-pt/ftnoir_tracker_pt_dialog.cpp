@@ -35,6 +35,9 @@ TrackerDialog_PT::TrackerDialog_PT(const QString& module_name) :
     tie_setting(s.cam_res_x, ui.res_x_spin);
     tie_setting(s.cam_res_y, ui.res_y_spin);
     tie_setting(s.cam_fps, ui.fps_spin);
+    tie_setting(s.cam_latest_frame, ui.latest_frame);
+    tie_setting(s.cam_mjpeg_luma, ui.mjpeg_luma);
+    tie_setting(s.idle_timeout, ui.idle_timeout);
 
     tie_setting(s.threshold_slider, ui.threshold_slider);
 
@@ -199,7 +202,13 @@ void TrackerDialog_PT::poll_tracker_info_impl()
     pt_camera_info info;
     if (tracker && tracker->get_cam_info(&info))
     {
-        ui.caminfo_label->setText(tr("%1x%2 @ %3 FPS").arg(info.res_x).arg(info.res_y).arg(iround(info.fps)));
+        const idle_gate::stats idle = tracker->get_idle_stats();
+        QString text = tr("%1x%2 @ %3 FPS, %4 ms old").arg(info.res_x).arg(info.res_y).arg(iround(info.fps))
+                                                       .arg(info.frame_age_ms, 0, 'f', 1);
+        text += tr(", %1% busy").arg(iround(idle.load * 100));
+        if (idle.idle)
+            text += tr(", idle");
+        ui.caminfo_label->setText(text);
 
         // display point info
         const int n_points = tracker->get_n_points();
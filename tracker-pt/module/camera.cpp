@@ -8,7 +8,6 @@
 #include "camera.h"
 #include "frame.hpp"
 
-#include "compat/sleep.hpp"
 #include "compat/camera-names.hpp"
 #include "compat/math-imports.hpp"
 
@@ -16,6 +15,8 @@
 
 #include "cv/video-property-page.hpp"
 
+#include <QDebug>
+
 using namespace pt_module;
 
 Camera::Camera(const QString& module_name) : s { module_name }
@@ -36,8 +37,8 @@ void Camera::show_camera_settings()
 {
     const int idx = camera_name_to_index(s.camera_name);
 
-    if (cap && cap->isOpened())
-        video_property_page::show_from_capture(*cap, idx);
+    if (cap && cap->is_open())
+        cap->show_settings();
     else
         video_property_page::show(idx);
 }
@@ -54,7 +55,8 @@ Camera::result Camera::get_frame(pt_frame& frame_)
 {
     cv::Mat& frame = frame_.as<Frame>()->mat;
 
-    const bool new_frame = _get_frame(frame);
+    // while idle, most frames are only checked for motion
+    const bool new_frame = _get_frame(frame) && idle.want_frame(frame);
 
     if (new_frame)
     {
@@ -74,6 +76,7 @@ Camera::result Camera::get_frame(pt_frame& frame_)
         cam_info.res_x = frame.cols;
         cam_info.res_y = frame.rows;
         cam_info.fov = fov;
+        cam_info.frame_age_ms = frame_age_ms;
 
         return result(true, cam_info);
     }
@@ -83,13 +86,19 @@ Camera::result Camera::get_frame(pt_frame& frame_)
 
 bool Camera::start(int idx, int fps, int res_x, int res_y)
 {
+    idle.set_timeout(s.idle_timeout);
+
     if (idx >= 0 && fps >= 0 && res_x >= 0 && res_y >= 0)
     {
+        const bool latest_ = s.cam_latest_frame, luma_ = s.cam_mjpeg_luma;
+
         if (cam_desired.idx != idx ||
             cam_desired.fps != fps ||
             cam_desired.res_x != res_x ||
             cam_desired.res_y != res_y ||
-            !cap || !cap->isOpened() || !cap->grab())
+            latest != latest_ ||
+            luma != luma_ ||
+            !cap || !cap->is_open())
         {
             stop();
 
@@ -99,17 +108,12 @@ bool Camera::start(int idx, int fps, int res_x, int res_y)
             cam_desired.res_x = res_x;
             cam_desired.res_y = res_y;
             cam_desired.fov = fov;
+            latest = latest_;
+            luma = luma_;
 
-            cap = camera_ptr(new cv::VideoCapture(cam_desired.idx));
+            cap = video::subscribe({ idx, fps, res_x, res_y, latest, luma });
 
-            if (cam_desired.res_x)
-                cap->set(cv::CAP_PROP_FRAME_WIDTH,  cam_desired.res_x);
-            if (cam_desired.res_y)
-                cap->set(cv::CAP_PROP_FRAME_HEIGHT, cam_desired.res_y);
-            if (cam_desired.fps)
-                cap->set(cv::CAP_PROP_FPS, cam_desired.fps);
-
-            if (cap->isOpened())
+            if (cap)
             {
                 cam_info = pt_camera_info();
                 active_name = QString();
@@ -119,7 +123,7 @@ bool Camera::start(int idx, int fps, int res_x, int res_y)
 
                 cv::Mat tmp;
 
-                if (_get_frame(tmp))
+                if (_get_frame(tmp, open_timeout_ms))
                 {
                     t.start();
                     return true;
@@ -139,34 +143,31 @@ bool Camera::start(int idx, int fps, int res_x, int res_y)
 
 void Camera::stop()
 {
+    if (cap && cap->dropped())
+        qDebug() << "pt: dropped" << cap->dropped() << "frames";
+    if (skipped)
+        qDebug() << "pt: skipped" << skipped << "queued frames";
     cap = nullptr;
+    skipped = 0;
     desired_name = QString();
     active_name = QString();
     cam_info = pt_camera_info();
     cam_desired = pt_camera_info();
 }
 
-bool Camera::_get_frame(cv::Mat& frame)
+bool Camera::_get_frame(cv::Mat& frame, int timeout_ms)
 {
-    if (cap && cap->isOpened())
+    if (cap)
     {
-        for (int i = 0; i < 5; i++)
+        // the buffer is shared with other subscribers of this camera,
+        // only the preview and point extractor read from it.
+        if (video::frame_ptr f = cap->next(timeout_ms))
         {
-            if (cap->read(frame))
-                return true;
-            portable::sleep(1);
+            frame = f->mat;
+            frame_age_ms = f->age_ms();
+            skipped += f->skipped;
+            return true;
         }
     }
     return false;
 }
-
-void Camera::camera_deleter::operator()(cv::VideoCapture* cap)
-{
-    if (cap)
-    {
-        if (cap->isOpened())
-            cap->release();
-        delete cap;
-    }
-}
-
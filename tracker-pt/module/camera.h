@@ -10,13 +10,13 @@
 #include "pt-api.hpp"
 
 #include "compat/timer.hpp"
+#include "video/capture-service.hpp"
 
 #include <functional>
 #include <memory>
 #include <tuple>
 
 #include <opencv2/core.hpp>
-#include <opencv2/videoio.hpp>
 
 #include <QString>
 
@@ -39,27 +39,28 @@ struct Camera final : pt_camera
     void set_fov(double value) override { fov = value; }
     void show_camera_settings() override;
 
+    bool frame_done(bool found) override { return idle.done(found); }
+    idle_gate::stats get_idle_stats() const override { return idle.get_stats(); }
+
 private:
-    warn_result_unused bool _get_frame(cv::Mat& Frame);
+    warn_result_unused bool _get_frame(cv::Mat& Frame, int timeout_ms = frame_timeout_ms);
 
-    double dt_mean = 0, fov = 30;
+    double dt_mean = 0, fov = 30, frame_age_ms = 0;
+    unsigned long long skipped = 0;
+    bool latest = false, luma = false;
     Timer t;
     pt_camera_info cam_info;
     pt_camera_info cam_desired;
     QString desired_name, active_name;
 
-    struct camera_deleter final
-    {
-        void operator()(cv::VideoCapture* cap);
-    };
-
-    using camera_ptr = std::unique_ptr<cv::VideoCapture, camera_deleter>;
-
-    camera_ptr cap;
+    video::subscription_ptr cap;
+    idle_gate idle;
 
     pt_settings s;
 
     static constexpr inline double dt_eps = 1./384;
+    static constexpr inline int frame_timeout_ms = 100;
+    static constexpr inline int open_timeout_ms = 2000;
 };
 
 } // ns pt_module
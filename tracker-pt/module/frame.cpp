@@ -11,9 +11,17 @@ using namespace pt_module;
 
 Preview& Preview::operator=(const pt_frame& frame_)
 {
-    const cv::Mat& frame = frame_.as_const<const Frame>()->mat;
+    const cv::Mat* src = &frame_.as_const<const Frame>()->mat;
     ensure_size(frame_copy, frame_out.cols, frame_out.rows, CV_8UC3);
 
+    if (src->channels() == 1)
+    {
+        cv::cvtColor(*src, frame_color, cv::COLOR_GRAY2BGR);
+        src = &frame_color;
+    }
+
+    const cv::Mat& frame = *src;
+
     if (frame.channels() != 3)
     {
         once_only(qDebug() << "tracker/pt: camera frame depth: 3 !=" << frame.channels());
@@ -126,6 +126,13 @@ void PointExtractor::extract_channels(const cv::Mat& orig_frame, const int* orde
 
 void PointExtractor::color_to_grayscale(const cv::Mat& frame, cv::Mat1b& output)
 {
+    // luma-only capture. the frame is shared, hence the copy.
+    if (frame.channels() == 1)
+    {
+        frame.copyTo(output);
+        return;
+    }
+
     switch (s.blob_color)
     {
     case pt_color_blue_only:
@@ -5,6 +5,7 @@
 #include "pt-settings.hpp"
 
 #include "cv/numeric.hpp"
+#include "cv/idle-gate.hpp"
 #include "options/options.hpp"
 
 #include <tuple>
@@ -24,6 +25,8 @@ struct OTR_PT_EXPORT pt_camera_info final
 
     double fov = 0;
     double fps = 0;
+    // how long the frame waited before the tracker got it
+    double frame_age_ms = 0;
 
     int res_x = 0;
     int res_y = 0;
@@ -83,6 +86,12 @@ struct OTR_PT_EXPORT pt_camera
 
     virtual void set_fov(double value) = 0;
     virtual void show_camera_settings() = 0;
+
+    // after each frame get_frame() returned, whether the model was found.
+    // cameras may hold back frames while nobody is in view. returns true
+    // if this ended idling.
+    virtual bool frame_done(bool found) { (void)found; return false; }
+    virtual idle_gate::stats get_idle_stats() const { return {}; }
 };
 
 struct OTR_PT_EXPORT pt_point_extractor : pt_pixel_pos_mixin
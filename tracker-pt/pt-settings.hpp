@@ -26,6 +26,11 @@ struct pt_settings final : options::opts
     value<int> cam_res_x { b, "camera-res-width", 640 },
                cam_res_y { b, "camera-res-height", 480 },
                cam_fps { b, "camera-fps", 30 };
+    value<bool> cam_latest_frame { b, "camera-latest-frame", false };
+    // ignores blob_color, there's only one channel
+    value<bool> cam_mjpeg_luma { b, "camera-mjpeg-luma-only", false };
+    // seconds without the model in view before going idle, 0 never
+    value<int> idle_timeout { b, "idle-timeout", 0 };
     value<double> min_point_size { b, "min-point-size", 2.5 },
                   max_point_size { b, "max-point-size", 50 };
 
@@ -4,11 +4,14 @@
 
 #include <cinttypes>
 #include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 
-tracker_s2bot::tracker_s2bot() : pose { 0,0,0, 0,0,0 }, m_nam (std::make_unique<QNetworkAccessManager>())
+tracker_s2bot::tracker_s2bot() : m_nam (std::make_unique<QNetworkAccessManager>())
 {
 }
 
@@ -27,62 +30,207 @@ static constexpr int add_cbx[] =
     -180,
 };
 
-void tracker_s2bot::run() {
-    if (s.freq == 0) s.freq = 10;
-    timer.setInterval(1000.0/s.freq);
-    timer.setSingleShot(false);
-    connect(&timer, &QTimer::timeout, [this]() {
-        auto reply = m_nam->get(QNetworkRequest(QUrl("http://localhost:17317/poll")));
-        connect(reply, &QNetworkReply::finished, [this, reply]() {
-            if (reply->error() == QNetworkReply::NoError) {
-                //qDebug() << "Request submitted OK";
-            }
-            else {
-                qWarning() << "Request bounced:" << reply->attribute(QNetworkRequest::HttpStatusCodeAttribute) << reply->errorString();
-                return;
-            }
-
-            const QStringList slist = QString::fromLatin1(reply->readAll()).split(QRegExp("[\r\n]+"), QString::SkipEmptyParts);
-            reply->close();
-            reply->deleteLater();
-
-            int order[] =
-            {
-                clamp(s.idx_x, 0, 3),
-                clamp(s.idx_y, 0, 3),
-                clamp(s.idx_z, 0, 3),
-            };
-
-            int add_indices[] = { s.add_yaw, s.add_pitch, s.add_roll, };
-            double orient[4] {};
-
-            for (auto line : slist)
-            {
-                QStringList keyval = line.split(' ');
-                if (keyval.count() < 2) continue;
-                if (keyval[0].startsWith("accelerometerZ")) orient[0] = keyval[1].toDouble();
-                else if (keyval[0].startsWith("accelerometerY")) orient[1] = keyval[1].toDouble();
-                else if (keyval[0].startsWith("accelerometerX")) orient[2] = keyval[1].toDouble();
-                else if (keyval[0].startsWith("bearing")) orient[3] = keyval[1].toDouble();
-            }
-
-            QMutexLocker foo(&mtx);
-
-            for (int i = 0; i < 3; i++)
-            {
-                const int axis = order[i];
-                const int add_idx = add_indices[i];
-                int add = 0;
-                if (add_idx >= 0 && add_idx < (int)std::size(add_cbx))
-                    add = add_cbx[add_idx];
-                pose[Yaw + i] = orient[axis] + add; // * r2d if it was radians
-            }
-        });
+void s2bot_pose_slot::store(const double (&x)[3])
+{
+    const unsigned k = seq.load(std::memory_order_relaxed);
+    seq.store(k + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < 3; i++)
+        values[i].store(x[i], std::memory_order_relaxed);
+    seq.store(k + 2, std::memory_order_release);
+}
+
+void s2bot_pose_slot::load(double (&x)[3]) const
+{
+    for (;;)
+    {
+        const unsigned k = seq.load(std::memory_order_acquire);
+        if (k & 1)
+            continue;
+        for (int i = 0; i < 3; i++)
+            x[i] = values[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) == k)
+            return;
+    }
+}
+
+template<unsigned N>
+static bool key_is(const char* key, const char* end, const char (&str)[N])
+{
+    // prefix match, same as the old QString::startsWith
+    return unsigned(end - key) >= N - 1 && !std::memcmp(key, str, N - 1);
+}
+
+void tracker_s2bot::parse_line(const char* line, const char* end)
+{
+    while (line < end && std::isspace((unsigned char)*line))
+        line++;
+
+    // SSE framing: "data: <key> <value>"
+    if (key_is(line, end, "data:"))
+    {
+        line += 5;
+        while (line < end && std::isspace((unsigned char)*line))
+            line++;
+    }
+
+    const char* key_end = std::find(line, end, ' ');
+    if (end - key_end < 2)
+        return;
+
+    // the buffer always has a delimiter past `end', so strtod stops there
+    const double value = std::strtod(key_end + 1, nullptr);
+
+    if (key_is(line, key_end, "accelerometerZ")) orient[0] = value;
+    else if (key_is(line, key_end, "accelerometerY")) orient[1] = value;
+    else if (key_is(line, key_end, "accelerometerX")) orient[2] = value;
+    else if (key_is(line, key_end, "bearing")) orient[3] = value;
+}
+
+void tracker_s2bot::publish()
+{
+    const int order[] =
+    {
+        clamp(s.idx_x, 0, 3),
+        clamp(s.idx_y, 0, 3),
+        clamp(s.idx_z, 0, 3),
+    };
+
+    const int add_indices[] = { s.add_yaw, s.add_pitch, s.add_roll, };
+    double rot[3];
+
+    for (int i = 0; i < 3; i++)
+    {
+        const int axis = order[i];
+        const int add_idx = add_indices[i];
+        int add = 0;
+        if (add_idx >= 0 && add_idx < (int)std::size(add_cbx))
+            add = add_cbx[add_idx];
+        rot[i] = orient[axis] + add; // * r2d if it was radians
+    }
+
+    pose.store(rot);
+}
+
+void tracker_s2bot::poll()
+{
+    auto reply = m_nam->get(QNetworkRequest(QUrl("http://localhost:17317/poll")));
+    connect(reply, &QNetworkReply::finished, [this, reply]() {
+        reply->deleteLater();
+
+        if (reply->error() != QNetworkReply::NoError)
+        {
+            qWarning() << "Request bounced:" << reply->attribute(QNetworkRequest::HttpStatusCodeAttribute) << reply->errorString();
+            return;
+        }
+
+        const QByteArray data = reply->readAll();
+        reply->close();
+
+        std::fill(std::begin(orient), std::end(orient), 0.);
+
+        const char* ptr = data.constData();
+        const char* const end = ptr + data.size();
+
+        while (ptr < end)
+        {
+            const char* eol = std::find_if(ptr, end, [](char c) { return c == '\r' || c == '\n'; });
+            parse_line(ptr, eol);
+            if (eol == end)
+                break;
+            ptr = eol + 1;
+        }
+
+        publish();
+    });
+}
+
+void tracker_s2bot::open_stream()
+{
+    buf.clear();
+
+    QNetworkRequest req(QUrl("http://localhost:17317/stream"));
+    req.setRawHeader("Accept", "text/event-stream");
+    req.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+
+    stream = m_nam->get(req);
+
+    connect(stream, &QNetworkReply::readyRead, [this]() { read_stream(); });
+    connect(stream, &QNetworkReply::finished, [this]() {
+        qWarning() << "s2bot: stream closed:"
+                   << stream->attribute(QNetworkRequest::HttpStatusCodeAttribute)
+                   << stream->errorString();
+        stream->deleteLater();
+        stream = nullptr;
+        // `timer' is single-shot in this mode
+        timer.start();
     });
+}
+
+void tracker_s2bot::read_stream()
+{
+    buf += stream->readAll();
+
+    const char* const begin = buf.constData();
+    const char* const end = begin + buf.size();
+    const char* ptr = begin;
+
+    for (;;)
+    {
+        const char* eol = std::find(ptr, end, '\n');
+        if (eol == end)
+            break;
+
+        const char* line_end = eol;
+        if (line_end > ptr && line_end[-1] == '\r')
+            line_end--;
+
+        // a blank line ends an event
+        if (line_end == ptr)
+            publish();
+        else
+            parse_line(ptr, line_end);
+
+        ptr = eol + 1;
+    }
+
+    if (end - ptr > max_line_length)
+    {
+        qWarning() << "s2bot: discarding garbage from stream";
+        ptr = end;
+    }
+
+    buf.remove(0, int(ptr - begin));
+}
+
+void tracker_s2bot::run() {
+    if (s.ingest == s2bot_ingest_stream)
+    {
+        timer.setInterval(reconnect_ms);
+        timer.setSingleShot(true);
+        connect(&timer, &QTimer::timeout, [this]() { open_stream(); });
+        open_stream();
+    }
+    else
+    {
+        if (s.freq == 0) s.freq = 10;
+        timer.setInterval(1000.0/s.freq);
+        timer.setSingleShot(false);
+        connect(&timer, &QTimer::timeout, [this]() { poll(); });
+        timer.start();
+    }
 
-    timer.start();
     exec();
     timer.stop();
+
+    if (stream)
+    {
+        stream->disconnect();
+        stream->abort();
+        delete stream;
+        stream = nullptr;
+    }
 }
 
 module_status tracker_s2bot::start_tracker(QFrame*)
@@ -96,11 +244,12 @@ module_status tracker_s2bot::start_tracker(QFrame*)
 
 void tracker_s2bot::data(double *data)
 {
-    QMutexLocker foo(&mtx);
+    double rot[3];
+    pose.load(rot);
 
-    data[Yaw] = pose[Yaw];
-    data[Pitch] = pose[Pitch];
-    data[Roll] = pose[Roll];
+    data[Yaw] = rot[0];
+    data[Pitch] = rot[1];
+    data[Roll] = rot[2];
 }
 
 OPENTRACK_DECLARE_TRACKER(tracker_s2bot, dialog_s2bot, meta_s2bot)
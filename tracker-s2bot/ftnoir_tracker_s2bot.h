@@ -6,18 +6,28 @@
  */
 #pragma once
 #include <cinttypes>
+#include <atomic>
 #include <QUdpSocket>
 #include <QThread>
 #include <QNetworkAccessManager>
+#include <QNetworkReply>
 #include <QTimer>
 #include "ui_s2bot-controls.h"
 #include "api/plugin-api.hpp"
 #include "options/options.hpp"
 using namespace options;
 
+enum s2bot_ingest
+{
+    s2bot_ingest_poll = 0,
+    // one long-lived GET, samples arrive as SSE-style events
+    s2bot_ingest_stream = 1,
+};
+
 struct settings : opts {
     value<int> freq, idx_x, idx_y, idx_z;
     value<int> add_yaw, add_pitch, add_roll;
+    value<s2bot_ingest> ingest;
     settings() :
         opts("s2bot-tracker"),
         freq(b, "freq", 30),
@@ -26,10 +36,22 @@ struct settings : opts {
         idx_z(b, "axis-index-z", 2),
         add_yaw(b, "add-yaw-degrees", 0),
         add_pitch(b, "add-pitch-degrees", 0),
-        add_roll(b, "add-roll-degrees", 0)
+        add_roll(b, "add-roll-degrees", 0),
+        ingest(b, "ingest-mode", s2bot_ingest_poll)
     {}
 };
 
+// single writer, any number of readers; readers retry on a torn read.
+class s2bot_pose_slot final
+{
+    std::atomic<unsigned> seq { 0 };
+    std::atomic<double> values[3] {};
+
+public:
+    void store(const double (&x)[3]);
+    void load(double (&x)[3]) const;
+};
+
 class tracker_s2bot : public ITracker, private virtual QThread
 {
 public:
@@ -40,12 +62,22 @@ public:
 protected:
     void run() override;
 private:
-    double pose[6];
+    void poll();
+    void open_stream();
+    void read_stream();
+    void parse_line(const char* line, const char* end);
+    void publish();
+
+    s2bot_pose_slot pose;
+    double orient[4] {};
 	QTimer timer;
     settings s;
-    QMutex mtx;
 	std::unique_ptr<QNetworkAccessManager> m_nam;
+    QNetworkReply* stream = nullptr;
+    QByteArray buf;
 
+    static constexpr inline int reconnect_ms = 1000;
+    static constexpr inline int max_line_length = 4096;
 };
 
 class dialog_s2bot : public ITrackerDialog
@@ -8,7 +8,11 @@ dialog_s2bot::dialog_s2bot()
     connect(ui.buttonBox, SIGNAL(accepted()), this, SLOT(doOK()));
     connect(ui.buttonBox, SIGNAL(rejected()), this, SLOT(doCancel()));
 
+    ui.ingest->addItem(tr("Poll"), s2bot_ingest_poll);
+    ui.ingest->addItem(tr("Stream"), s2bot_ingest_stream);
+
     tie_setting(s.freq, ui.freq);
+    tie_setting(s.ingest, ui.ingest);
     tie_setting(s.idx_x, ui.input_x);
     tie_setting(s.idx_y, ui.input_y);
     tie_setting(s.idx_z, ui.input_z);
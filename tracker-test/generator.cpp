@@ -0,0 +1,181 @@
+#include "generator.hpp"
+#include "compat/math.hpp"
+#include "compat/math-imports.hpp"
+
+#include <algorithm>
+
+#include <QFile>
+#include <QDebug>
+
+// the original fixed-rate motion, units per second
+static const double sawtooth_incr[6] =
+{
+    50, 40, 80,
+    70, 5, 3
+};
+
+test_generator::test_generator(const test_settings& s) :
+    waveform(s.waveform),
+    rot_amp(s.rot_amplitude), pos_amp(s.pos_amplitude),
+    f0(std::max(1e-3, s.freq_min())), f1(std::max(1e-3, s.freq_max())),
+    T(std::max(1e-3, s.period()))
+{
+    if (waveform == test_replay)
+        load_replay(s.replay_file);
+}
+
+double test_generator::amplitude(int axis) const
+{
+    return axis >= 3 ? rot_amp : pos_amp;
+}
+
+void test_generator::sample(double t, double (&out)[6])
+{
+    const double dt = std::max(0., t - last_t);
+    last_t = t;
+
+    switch (waveform)
+    {
+    default:
+    case test_sawtooth: sawtooth(dt, out); break;
+    case test_sine_sweep: sine_sweep(t, out); break;
+    case test_step: step(t, out); break;
+    case test_noise: noise(dt, out); break;
+    case test_replay: play(t, out); break;
+    }
+}
+
+test_sample test_generator::next(double t)
+{
+    test_sample ret;
+    ret.t = t;
+    ret.seq = ++seq;
+    sample(t, ret.pose);
+    return ret;
+}
+
+void test_generator::sawtooth(double dt, double (&out)[6])
+{
+    for (int i = 0; i < 6; i++)
+    {
+        double x = state[i] + sawtooth_incr[i] * dt;
+        if (x > 180)
+            x = -360 + x;
+        else if (x < -180)
+            x = 360 + x;
+        x = copysign(fmod(fabs(x), 360), x);
+        state[i] = x;
+
+        if (i >= 3)
+            out[i] = x;
+        else
+            out[i] = x * 100/180.;
+    }
+}
+
+void test_generator::sine_sweep(double t, double (&out)[6]) const
+{
+    // exponential chirp from f0 to f1 over one period, then start over
+    const double tau = fmod(t, T);
+    const double k = f1 / f0;
+    double phase;
+
+    if (fabs(k - 1) < 1e-9)
+        phase = 2 * M_PI * f0 * tau;
+    else
+        phase = 2 * M_PI * f0 * T / log(k) * (pow(k, tau / T) - 1);
+
+    for (int i = 0; i < 6; i++)
+        out[i] = amplitude(i) * sin(phase + i * M_PI / 3);
+}
+
+void test_generator::step(double t, double (&out)[6]) const
+{
+    // square wave, each axis a twelfth of a period behind the previous
+    for (int i = 0; i < 6; i++)
+    {
+        const double x = fmod(t + T - i * T / 12, T);
+        out[i] = amplitude(i) * (x < T/2 ? 1 : -1);
+    }
+}
+
+void test_generator::noise(double dt, double (&out)[6])
+{
+    // white noise through a one-pole lowpass at f1. the input is scaled
+    // so the output's standard deviation is a third of the amplitude.
+    const double alpha = 1 - exp(-2 * M_PI * f1 * dt);
+
+    if (alpha <= 0)
+    {
+        std::copy(std::begin(state), std::end(state), std::begin(out));
+        return;
+    }
+
+    const double gain = sqrt((2 - alpha) / alpha) / 3;
+
+    for (int i = 0; i < 6; i++)
+    {
+        const double a = amplitude(i);
+        const double x = a * gain * normal(rng);
+        state[i] += alpha * (x - state[i]);
+        out[i] = clamp(state[i], -a, a);
+    }
+}
+
+void test_generator::play(double t, double (&out)[6])
+{
+    if (!replay_loaded())
+    {
+        std::fill(std::begin(out), std::end(out), 0.);
+        return;
+    }
+
+    const double len = replay.back().t;
+    const double x = len > 0 ? fmod(t, len) : 0;
+
+    if (x < replay[replay_pos].t)
+        replay_pos = 0;
+    while (replay_pos + 1 < replay.size() && replay[replay_pos + 1].t <= x)
+        replay_pos++;
+
+    std::copy(std::begin(replay[replay_pos].pose), std::end(replay[replay_pos].pose), std::begin(out));
+}
+
+void test_generator::load_replay(const QString& filename)
+{
+    // pose log as written by the pipeline's tracklogger: a header line,
+    // then dt followed by the raw pose and further columns.
+    QFile f(filename);
+
+    if (!f.open(QFile::ReadOnly | QFile::Text))
+    {
+        qDebug() << "test tracker: can't open" << filename << f.errorString();
+        return;
+    }
+
+    double t = 0;
+
+    while (!f.atEnd())
+    {
+        const QList<QByteArray> cols = f.readLine().split(',');
+
+        if (cols.size() < 7)
+            continue;
+
+        frame r;
+        bool ok = true;
+        const double dt = cols[0].trimmed().toDouble(&ok);
+
+        for (int i = 0; ok && i < 6; i++)
+            r.pose[i] = cols[1 + i].trimmed().toDouble(&ok);
+
+        if (!ok)
+            continue;
+
+        t += std::max(0., dt);
+        r.t = t;
+        replay.push_back(r);
+    }
+
+    qDebug() << "test tracker: loaded" << replay.size() << "samples," << t << "seconds from" << filename;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "options/options.hpp"
+
+#include <random>
+#include <vector>
+
+#include <QString>
+
+using namespace options;
+
+enum test_waveform
+{
+    test_sawtooth = 0,
+    test_sine_sweep = 1,
+    test_step = 2,
+    test_noise = 3,
+    test_replay = 4,
+};
+
+struct test_settings final : opts
+{
+    value<test_waveform> waveform;
+    value<int> rate;
+    value<double> rot_amplitude, pos_amplitude;
+    value<double> freq_min, freq_max, period;
+    value<QString> replay_file;
+
+    test_settings() :
+        opts("test-tracker"),
+        waveform(b, "waveform", test_sawtooth),
+        rate(b, "sample-rate", 250),
+        rot_amplitude(b, "rotation-amplitude", 60),
+        pos_amplitude(b, "position-amplitude", 20),
+        freq_min(b, "min-frequency", .1),
+        freq_max(b, "max-frequency", 5),
+        period(b, "period", 10),
+        replay_file(b, "replay-file", QString())
+    {}
+};
+
+// A pose with the time it's for. The test tracker hands these out, and
+// opentrack-bench feeds them to the pipeline, filters and protocols.
+struct test_sample final
+{
+    double t = 0; // seconds since the first sample
+    unsigned long long seq = 0;
+    double pose[6] {};
+};
+
+// Deterministic pose source. `t' is seconds since the first sample and
+// must not decrease between calls. Parameters are copied at construction
+// so sampling doesn't go through the settings bundle.
+class test_generator final
+{
+public:
+    explicit test_generator(const test_settings& s);
+    void sample(double t, double (&out)[6]);
+    // the sample for `t', numbered in order from 1
+    test_sample next(double t);
+
+    bool replay_loaded() const { return replay.size() >= 2; }
+
+private:
+    void sawtooth(double dt, double (&out)[6]);
+    void sine_sweep(double t, double (&out)[6]) const;
+    void step(double t, double (&out)[6]) const;
+    void noise(double dt, double (&out)[6]);
+    void play(double t, double (&out)[6]);
+    void load_replay(const QString& filename);
+
+    double amplitude(int axis) const;
+
+    test_waveform waveform;
+    double rot_amp, pos_amp, f0, f1, T;
+
+    double last_t = 0;
+    unsigned long long seq = 0;
+    double state[6] {};
+
+    std::mt19937 rng { 0x7e57 };
+    std::normal_distribution<double> normal;
+
+    struct frame { double t; double pose[6]; };
+    std::vector<frame> replay;
+    unsigned replay_pos = 0;
+};
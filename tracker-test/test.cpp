@@ -8,44 +8,85 @@
 
 #include "test.h"
 #include "api/plugin-api.hpp"
-#include "compat/math-imports.hpp"
+#include "compat/math.hpp"
+#include "compat/sleep.hpp"
 
 #include <QPushButton>
+#include <QFileDialog>
+#include <QFileInfo>
 
+#include <algorithm>
 #include <cmath>
 #include <QDebug>
 
-const double test_tracker::incr[6] =
-{
-    50, 40, 80,
-    70, 5, 3
-};
-
-test_tracker::test_tracker() :
-    last_x { 0, 0, 0, 0, 0, 0 }
-{
-}
+test_tracker::test_tracker() = default;
 
 test_tracker::~test_tracker()
 {
+    requestInterruption();
+    wait();
 }
 
 module_status test_tracker::start_tracker(QFrame*)
 {
-    t.start();
+    if (s.waveform == test_replay && !test_generator(s).replay_loaded())
+        return error(_("Can't load replay file \"%1\"").arg(s.replay_file()));
+
+    start(QThread::HighPriority);
 
     return status_ok();
 }
 
+void test_tracker::run()
+{
+    test_generator gen(s);
+
+    const double dt = 1. / clamp(s.rate, 1, max_rate);
+    unsigned long long n = 0;
+    Timer t;
+
+    while (!isInterruptionRequested())
+    {
+        const double now = t.elapsed_seconds();
+
+        // after a long stall, don't try to make up for all of it
+        if (now - n * dt > 1)
+            n = (unsigned long long)(now / dt);
+
+        // the OS won't sleep for less than about a millisecond, so at high
+        // rates emit every sample that's due by now in one go.
+        if (n * dt <= now)
+        {
+            sample x;
+
+            do
+            {
+                x = gen.next(n * dt);
+                n++;
+            }
+            while (n * dt <= now);
+
+            QMutexLocker l(&mtx);
+            last = x;
+        }
+
+        const int ms = int((n * dt - t.elapsed_seconds()) * 1000);
+        portable::sleep(std::max(1, ms));
+    }
+}
+
+test_tracker::sample test_tracker::latest() const
+{
+    QMutexLocker l(&mtx);
+    return last;
+}
+
 #ifdef EMIT_NAN
 #   include <cstdlib>
 #endif
 
 void test_tracker::data(double *data)
 {
-    const double dt = t.elapsed_seconds();
-    t.start();
-
 #ifdef EMIT_NAN
     if ((rand()%4) == 0)
     {
@@ -54,25 +95,11 @@ void test_tracker::data(double *data)
     }
     else
 #endif
+    {
+        const sample x = latest();
         for (int i = 0; i < 6; i++)
-        {
-            double x = last_x[i] + incr[i] * dt;
-            if (x > 180)
-                x = -360 + x;
-            else if (x < -180)
-                x = 360 + x;
-            x = copysign(fmod(fabs(x), 360), x);
-            last_x[i] = x;
-
-            if (i >= 3)
-            {
-                data[i] = x;
-            }
-            else
-            {
-                data[i] = x * 100/180.;
-            }
-        }
+            data[i] = x.pose[i];
+    }
 }
 
 test_dialog::test_dialog()
@@ -86,11 +113,54 @@ test_dialog::test_dialog()
 
     connect(ui.buttonBox, SIGNAL(accepted()), this, SLOT(doOK()));
     connect(ui.buttonBox, SIGNAL(rejected()), this, SLOT(doCancel()));
+
+    ui.waveform->addItem(tr("Sawtooth"), test_sawtooth);
+    ui.waveform->addItem(tr("Sine sweep"), test_sine_sweep);
+    ui.waveform->addItem(tr("Steps"), test_step);
+    ui.waveform->addItem(tr("Band-limited noise"), test_noise);
+    ui.waveform->addItem(tr("Replay pose log"), test_replay);
+
+    tie_setting(s.waveform, ui.waveform);
+    tie_setting(s.rate, ui.rate);
+    tie_setting(s.rot_amplitude, ui.rot_amplitude);
+    tie_setting(s.pos_amplitude, ui.pos_amplitude);
+    tie_setting(s.freq_min, ui.freq_min);
+    tie_setting(s.freq_max, ui.freq_max);
+    tie_setting(s.period, ui.period);
+    tie_setting(s.replay_file, ui.replay_file);
+
+    connect(ui.replay_browse, SIGNAL(clicked()), this, SLOT(browse_replay_file()));
+    connect(&s.waveform, base_value::value_changed<int>(), this, &test_dialog::update_enabled);
+    update_enabled();
+}
+
+void test_dialog::browse_replay_file()
+{
+    const QString name = QFileDialog::getOpenFileName(this,
+                                                      tr("Select pose log"),
+                                                      QFileInfo(s.replay_file()).absolutePath(),
+                                                      tr("CSV file (*.csv *.txt)"));
+    if (!name.isEmpty())
+        ui.replay_file->setText(name);
+}
+
+void test_dialog::update_enabled()
+{
+    const test_waveform w = s.waveform;
+    const bool sawtooth = w == test_sawtooth, replay = w == test_replay;
+
+    ui.rot_amplitude->setEnabled(!sawtooth && !replay);
+    ui.pos_amplitude->setEnabled(!sawtooth && !replay);
+    ui.freq_min->setEnabled(w == test_sine_sweep);
+    ui.freq_max->setEnabled(w == test_sine_sweep || w == test_noise);
+    ui.period->setEnabled(w == test_sine_sweep || w == test_step);
+    ui.replay_file->setEnabled(replay);
+    ui.replay_browse->setEnabled(replay);
 }
 
 void test_dialog::doOK()
 {
-    //s.b->save();
+    s.b->save();
     close();
 }
 
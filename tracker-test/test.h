@@ -1,23 +1,36 @@
 #pragma once
 #include "ui_test.h"
+#include "generator.hpp"
 #include "api/plugin-api.hpp"
 #include "compat/timer.hpp"
 #include "compat/macros.hpp"
 
 #include <cmath>
 
-class test_tracker : public ITracker
+#include <QThread>
+#include <QMutex>
+
+class test_tracker : public ITracker, private QThread
 {
 public:
+    using sample = test_sample;
+
     test_tracker();
     ~test_tracker() override;
     module_status start_tracker(QFrame *) override;
     void data(double *data) override;
 
+    // newest sample with its timestamp
+    sample latest() const;
+
 private:
-    static const double incr[6];
-    double last_x[6];
-    Timer t;
+    void run() override;
+
+    test_settings s;
+    mutable QMutex mtx;
+    sample last;
+
+    static constexpr inline int max_rate = 10000;
 };
 
 class test_dialog : public ITrackerDialog
@@ -25,6 +38,7 @@ class test_dialog : public ITrackerDialog
     Q_OBJECT
 
     Ui::test_ui ui;
+    test_settings s;
 public:
     test_dialog();
     void register_tracker(ITracker *) override {}
@@ -32,6 +46,8 @@ public:
 private slots:
     void doOK();
     void doCancel();
+    void browse_replay_file();
+    void update_enabled();
 };
 
 class test_metadata : public Metadata
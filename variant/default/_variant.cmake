@@ -21,7 +21,9 @@ function(otr_init_variant)
         "qxt-mini"
         "macosx"
         "cv"
-        "migration")
+        "video"
+        "migration"
+        "bench")
 
     set_property(GLOBAL PROPERTY opentrack-subprojects "${subprojects}")
 endfunction()
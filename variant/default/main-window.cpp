@@ -122,6 +122,8 @@ main_window::main_window() :
         profile_menu.addAction(tr("Create new empty config"), this, SLOT(make_empty_config()));
         profile_menu.addAction(tr("Create new copied config"), this, SLOT(make_copied_config()));
         profile_menu.addAction(tr("Open configuration directory"), this, SLOT(open_config_directory()));
+        profile_menu.addSeparator();
+        profile_menu.addAction(tr("Show thread usage"), this, SLOT(show_thread_usage()));
         ui.profile_button->setMenu(&profile_menu);
     }
 
@@ -162,6 +164,10 @@ main_window::main_window() :
         tie_setting(m.tracker_dll, ui.iconcomboTrackerSource);
         tie_setting(m.protocol_dll, ui.iconcomboProtocol);
         tie_setting(m.filter_dll, ui.iconcomboFilter);
+
+        // these two can change while tracking
+        connect(ui.iconcomboProtocol, &QComboBox::currentTextChanged, this, [this](const QString&) { swap_protocol(); });
+        connect(ui.iconcomboFilter, &QComboBox::currentTextChanged, this, [this](const QString&) { swap_filter(); });
     }
 
     connect(this, &main_window::start_tracker,
@@ -472,8 +478,6 @@ void main_window::update_button_state(bool running, bool inertialp)
     ui.iconcomboProfile->setEnabled(not_running);
     ui.btnStartTracker->setEnabled(not_running);
     ui.btnStopTracker->setEnabled(running);
-    ui.iconcomboProtocol->setEnabled(not_running);
-    ui.iconcomboFilter->setEnabled(not_running);
     ui.iconcomboTrackerSource->setEnabled(not_running);
     ui.profile_button->setEnabled(not_running);
     ui.video_frame_label->setVisible(not_running || inertialp);
@@ -504,6 +508,11 @@ void main_window::start_tracker_()
         return;
     }
 
+    running_filter = m.filter_dll();
+    running_protocol = m.protocol_dll();
+
+    work->start_seats(modules, Work::seat_profiles());
+
     if (pTrackerDialog)
         pTrackerDialog->register_tracker(work->libs.pTracker.get());
 
@@ -645,7 +654,7 @@ template<typename t>
 bool main_window::mk_dialog(std::shared_ptr<dylib> lib, std::unique_ptr<t>& d)
 {
     const bool just_created = mk_window_common(d, [&]() -> t* {
-        if (lib && lib->Dialog)
+        if (lib && lib->load())
             return (t*) lib->Dialog();
         return nullptr;
     });
@@ -653,6 +662,50 @@ bool main_window::mk_dialog(std::shared_ptr<dylib> lib, std::unique_ptr<t>& d)
     return just_created;
 }
 
+void main_window::swap_filter()
+{
+    if (!work)
+        return;
+
+    // the dialog is for the old module
+    if (pFilterDialog)
+    {
+        pFilterDialog->unregister_filter();
+        pFilterDialog = nullptr;
+    }
+
+    if (work->swap_filter(current_filter()))
+        running_filter = m.filter_dll();
+    else
+    {
+        // the combo first, so setting the value doesn't swap again
+        QSignalBlocker b(ui.iconcomboFilter);
+        ui.iconcomboFilter->setCurrentText(running_filter);
+        m.filter_dll = running_filter;
+    }
+}
+
+void main_window::swap_protocol()
+{
+    if (!work)
+        return;
+
+    if (pProtocolDialog)
+    {
+        pProtocolDialog->unregister_protocol();
+        pProtocolDialog = nullptr;
+    }
+
+    if (work->swap_protocol(current_protocol()))
+        running_protocol = m.protocol_dll();
+    else
+    {
+        QSignalBlocker b(ui.iconcomboProtocol);
+        ui.iconcomboProtocol->setCurrentText(running_protocol);
+        m.protocol_dll = running_protocol;
+    }
+}
+
 void main_window::show_tracker_settings()
 {
     if (mk_dialog(current_tracker(), pTrackerDialog) && work && work->libs.pTracker)
@@ -697,6 +750,11 @@ void main_window::show_mapping_window()
     mk_window(mapping_widget, pose);
 }
 
+void main_window::show_thread_usage()
+{
+    mk_window(thread_usage_widget);
+}
+
 void main_window::exit(int status)
 {
     QApplication::setQuitOnLastWindowClosed(true);
@@ -865,7 +923,7 @@ void main_window::set_keys_enabled(bool flag)
     if (!flag)
     {
         if (work)
-            work->sc->reload({});
+            work->unload_shortcuts();
         global_shortcuts.reload({});
     }
     else
@@ -12,12 +12,14 @@
 #include "gui/mapping-dialog.hpp"
 #include "gui/settings.hpp"
 #include "gui/process_detector.h"
+#include "gui/thread-usage.hpp"
 #include "logic/main-settings.hpp"
 #include "logic/pipeline.hpp"
 #include "logic/shortcuts.h"
 #include "logic/work.hpp"
 #include "logic/state.hpp"
 #include "options/options.hpp"
+#include "compat/thread-monitor.hpp"
 
 #include <QApplication>
 #include <QMainWindow>
@@ -46,6 +48,7 @@ class main_window : public QMainWindow, private State
 
     Ui::main_window ui;
 
+    thread_monitor gui_monitor { "gui" };
     Shortcuts global_shortcuts;
     module_settings m;
     std::unique_ptr<QSystemTrayIcon> tray;
@@ -55,10 +58,13 @@ class main_window : public QMainWindow, private State
     QTimer config_list_timer;
     std::unique_ptr<options_dialog> options_widget;
     std::unique_ptr<mapping_dialog> mapping_widget;
+    std::unique_ptr<thread_usage_dialog> thread_usage_widget;
     QShortcut kbd_quit { QKeySequence("Ctrl+Q"), this };
     std::unique_ptr<IFilterDialog> pFilterDialog;
     std::unique_ptr<IProtocolDialog> pProtocolDialog;
     std::unique_ptr<ITrackerDialog> pTrackerDialog;
+    // what's running, for putting the combos back after a failed swap
+    QString running_filter, running_protocol;
 
     process_detector_worker det;
     QMenu profile_menu;
@@ -125,6 +131,9 @@ private slots:
     void show_filter_settings();
     void show_options_dialog();
     void show_mapping_window();
+    void show_thread_usage();
+    void swap_filter();
+    void swap_protocol();
     void show_pose();
 
     void maybe_start_profile_from_executable();
@@ -0,0 +1,24 @@
+function(otr_init_variant)
+    set_property(GLOBAL PROPERTY opentrack-variant "headless")
+    set_property(GLOBAL PROPERTY opentrack-ident "opentrack-2.3")
+
+    set(subprojects
+        "tracker-*"
+        "proto-*"
+        "filter-*"
+        "ext-*"
+        "options"
+        "api"
+        "compat"
+        "logic"
+        "dinput"
+        "csv"
+        "spline"
+        "qxt-mini"
+        "cv"
+        "video"
+        "migration"
+        "bench")
+
+    set_property(GLOBAL PROPERTY opentrack-subprojects "${subprojects}")
+endfunction()
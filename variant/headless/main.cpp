@@ -0,0 +1,253 @@
+// Runs tracking from a profile without any user interface. Meant for
+// machines without a display; trackers get a hidden frame on the offscreen
+// platform plugin.
+
+#include "logic/state.hpp"
+#include "logic/work.hpp"
+#include "migration/migration.hpp"
+#include "options/options.hpp"
+#include "compat/library-path.hpp"
+#include "compat/thread-monitor.hpp"
+
+#include <memory>
+#include <cstdlib>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFrame>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QTranslator>
+#include <QVariant>
+#include <QDebug>
+
+#if !defined _WIN32
+#   include <csignal>
+#   include <sys/socket.h>
+#   include <unistd.h>
+#   include <QSocketNotifier>
+#endif
+
+#if defined __x86_64__ || defined __SSE2__ || defined _M_AMD64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#   include <xmmintrin.h>
+#   include <pmmintrin.h>
+#   define OTR_HAS_DENORM_CONTROL
+#endif
+
+using namespace options;
+
+using dylib_ptr = std::shared_ptr<dylib>;
+
+static dylib_ptr find_module(Modules::dylib_list& list, const QString& name)
+{
+    for (dylib_ptr& lib : list)
+        if (lib->name == name)
+            return lib;
+    return nullptr;
+}
+
+// profiles are stored as "name.ini", but either may be given
+static QString profile_filename(QString name)
+{
+    if (!name.endsWith(".ini"))
+        name += ".ini";
+    return name;
+}
+
+// --profile is for this run only, the GUI keeps its last used profile
+struct restore_last_profile final
+{
+    bool active = false;
+    QVariant value;
+
+    ~restore_last_profile()
+    {
+        if (!active)
+            return;
+
+        group::with_global_settings_object([this](QSettings& s) {
+            if (value.isValid())
+                s.setValue(OPENTRACK_CONFIG_FILENAME_KEY, value);
+            else
+                s.remove(OPENTRACK_CONFIG_FILENAME_KEY);
+        });
+    }
+};
+
+#if !defined _WIN32
+static int signal_fds[2] = { -1, -1 };
+
+static void on_signal(int)
+{
+    char c = 0;
+    // only async-signal-safe calls here, the notifier does the rest
+    (void)!write(signal_fds[0], &c, 1);
+}
+
+static void quit_on_signals(QCoreApplication& app)
+{
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, signal_fds))
+    {
+        qDebug() << "can't create signal socketpair";
+        return;
+    }
+
+    auto notifier = new QSocketNotifier(signal_fds[1], QSocketNotifier::Read, &app);
+    QObject::connect(notifier, &QSocketNotifier::activated, &app, [&app](int) {
+        char c;
+        (void)!read(signal_fds[1], &c, 1);
+        qDebug() << "got signal, exiting";
+        app.quit();
+    });
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGHUP, on_signal);
+}
+#endif
+
+int main(int argc, char** argv)
+{
+#if defined OTR_HAS_DENORM_CONTROL
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    _MM_SET_ROUNDING_MODE(_MM_ROUND_NEAREST);
+    _MM_SET_EXCEPTION_MASK(_MM_MASK_MASK);
+#endif
+
+    // trackers want a QFrame, but nothing is ever shown
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setQuitOnLastWindowClosed(false);
+
+    QDir::setCurrent(OPENTRACK_BASE_PATH);
+
+    QCommandLineParser args;
+    args.setApplicationDescription("opentrack without a user interface");
+    args.addHelpOption();
+    args.addOption({ { "p", "profile" }, "Profile to load instead of the last used one.", "name" });
+    args.addOption({ { "s", "seat" }, "Also track from this profile. Can be given more than once.", "name" });
+    args.addOption({ "thread-usage", "On exit, write threads' CPU time and allocations here as JSON.", "file" });
+#ifdef __linux__
+    args.addOption({ "evdev-latency", "On exit, write the direct input shortcuts' latency here as JSON.", "file" });
+#endif
+    args.process(app);
+
+    // module names in the profile are stored translated
+    QTranslator t;
+    {
+        const bool no_i18n = group::with_global_settings_object([](QSettings& s) {
+            return s.value("disable-translation", false).toBool();
+        });
+
+        if (!no_i18n)
+        {
+            (void) t.load(QLocale(), "", "", OPENTRACK_BASE_PATH + "/" OPENTRACK_I18N_PATH, ".qm");
+            (void) QCoreApplication::installTranslator(&t);
+        }
+    }
+
+    // before anything that saves to the profile, so it's put back last
+    restore_last_profile last_profile;
+
+    if (args.isSet("profile"))
+    {
+        const QString profile = profile_filename(args.value("profile"));
+
+        if (!group::ini_list().contains(profile))
+        {
+            qDebug() << "no such profile" << profile;
+            return EXIT_FAILURE;
+        }
+
+        group::with_global_settings_object([&](QSettings& s) {
+            last_profile.value = s.value(OPENTRACK_CONFIG_FILENAME_KEY);
+            last_profile.active = true;
+            s.setValue(OPENTRACK_CONFIG_FILENAME_KEY, profile);
+        });
+    }
+
+    qDebug() << "profile" << group::ini_filename();
+
+    options::detail::bundler::refresh_all_bundles();
+    run_migrations();
+
+    State state(OPENTRACK_BASE_PATH + OPENTRACK_LIBRARY_PATH);
+    module_settings m;
+
+    const dylib_ptr tracker = find_module(state.modules.trackers(), m.tracker_dll);
+    const dylib_ptr proto = find_module(state.modules.protocols(), m.protocol_dll);
+    const dylib_ptr filter = find_module(state.modules.filters(), m.filter_dll);
+
+    if (!tracker || !proto)
+    {
+        qDebug() << "tracker" << m.tracker_dll() << "or protocol" << m.protocol_dll() << "not found";
+        return EXIT_FAILURE;
+    }
+
+    QFrame frame;
+
+    // same argument order as the main window
+    state.work = std::make_shared<Work>(state.pose, state.ev, &frame, tracker, proto, filter, false);
+
+    if (!state.work->is_ok())
+        return EXIT_FAILURE;
+
+    qDebug() << "tracking with" << tracker->name << proto->name << (filter ? filter->name : QString());
+
+    QStringList seats = args.isSet("seat") ? args.values("seat") : Work::seat_profiles();
+    for (QString& x : seats)
+        x = profile_filename(x);
+    state.work->start_seats(state.modules, seats);
+
+#if !defined _WIN32
+    quit_on_signals(app);
+#endif
+
+    thread_monitor monitor("main");
+
+    const int ret = app.exec();
+
+    // while the tracking threads are still there. with no earlier sample,
+    // load is over each thread's whole run.
+    if (args.isSet("thread-usage"))
+    {
+        const QJsonObject usage {
+            { "counts-allocations", thread_monitor::counts_allocations() },
+            { "threads", thread_monitor::to_json(thread_monitor::sample()) },
+        };
+
+        QFile f(args.value("thread-usage"));
+        if (!f.open(QFile::WriteOnly | QFile::Truncate) || f.write(QJsonDocument(usage).toJson()) < 0)
+            qDebug() << "can't write" << f.fileName() << f.errorString();
+    }
+
+#ifdef __linux__
+    if (args.isSet("evdev-latency"))
+    {
+        evdev_shortcuts::latency_stats x;
+        if (state.work->evdev)
+            x = state.work->evdev->latency();
+
+        const QJsonObject latency {
+            { "count", (int)x.count },
+            { "min-ms", x.min },
+            { "median-ms", x.median },
+            { "max-ms", x.max },
+        };
+
+        QFile f(args.value("evdev-latency"));
+        if (!f.open(QFile::WriteOnly | QFile::Truncate) || f.write(QJsonDocument(latency).toJson()) < 0)
+            qDebug() << "can't write" << f.fileName() << f.errorString();
+    }
+#endif
+
+    state.work = nullptr;
+
+    return ret;
+}
@@ -14,6 +14,7 @@ function(otr_init_variant)
         "pose-widget"
         "spline"
         "cv"
+        "video"
         "migration")
     set_property(GLOBAL PROPERTY opentrack-subprojects "${subprojects}")
 endfunction()
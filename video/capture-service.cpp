@@ -0,0 +1,365 @@
+#include "capture-service.hpp"
+
+#include "compat/camera-names.hpp"
+#include "compat/sleep.hpp"
+#include "compat/thread-monitor.hpp"
+#include "cv/video-property-page.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <utility>
+
+#include <opencv2/videoio.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QDebug>
+
+namespace video {
+
+bool capture_params::operator==(const capture_params& x) const
+{
+    return idx == x.idx && fps == x.fps && res_x == x.res_x && res_y == x.res_y &&
+           latest == x.latest && luma == x.luma;
+}
+
+struct device final : QThread
+{
+    explicit device(const capture_params& params);
+    ~device() override;
+
+    bool open();
+    void stop();
+    void run() override;
+    bool read_latest(cv::Mat& mat, unsigned& skipped, Timer& grabbed);
+
+    const capture_params params;
+    const QString name;
+
+    cv::VideoCapture cap;
+    QMutex cap_mtx;
+
+    // guards everything below, and each subscriber's pending frame
+    QMutex mtx;
+    QWaitCondition cond;
+    std::vector<subscription*> subscribers;
+    unsigned long long seq = 0;
+    bool running = false;
+
+    // set in open(), then only used by the capture thread
+    double frame_ms = 1000./30;
+    Timer since_grab;
+
+    // consecutive failed reads before the device is considered gone
+    static constexpr inline int max_failures = 500;
+    // enough to get through any driver queue
+    static constexpr inline unsigned max_skipped = 8;
+};
+
+namespace {
+
+struct registry final
+{
+    QMutex mtx;
+    std::map<int, std::shared_ptr<device>> devices;
+};
+
+registry& get_registry()
+{
+    static registry ret;
+    return ret;
+}
+
+} // ns
+
+device::device(const capture_params& params) :
+    params(params), name(get_camera_names().value(params.idx))
+{
+}
+
+device::~device()
+{
+    stop();
+}
+
+bool device::open()
+{
+    QMutexLocker l(&cap_mtx);
+
+    if (!cap.open(params.idx))
+        return false;
+
+    // before the resolution, some drivers only have it in one format.
+    // without conversion, the backend returns the compressed buffer.
+    if (params.luma &&
+        !(cap.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G')) &&
+          cap.set(cv::CAP_PROP_CONVERT_RGB, 0)))
+        qDebug() << "video: no MJPEG passthrough for" << name << "converting to gray instead";
+
+    if (params.res_x)
+        cap.set(cv::CAP_PROP_FRAME_WIDTH, params.res_x);
+    if (params.res_y)
+        cap.set(cv::CAP_PROP_FRAME_HEIGHT, params.res_y);
+    if (params.fps)
+        cap.set(cv::CAP_PROP_FPS, params.fps);
+    if (params.latest && !cap.set(cv::CAP_PROP_BUFFERSIZE, 1))
+        qDebug() << "video: can't shrink the driver queue for" << name;
+
+    if (!cap.isOpened())
+        return false;
+
+    if (double fps = cap.get(cv::CAP_PROP_FPS); fps > 0)
+        frame_ms = 1000 / fps;
+    else if (params.fps > 0)
+        frame_ms = 1000. / params.fps;
+
+    running = true;
+    start(QThread::HighPriority);
+
+    return true;
+}
+
+void device::stop()
+{
+    requestInterruption();
+    wait();
+
+    QMutexLocker l(&cap_mtx);
+    if (cap.isOpened())
+        cap.release();
+}
+
+// Whatever the backend gave us, as 8-bit gray. A compressed buffer comes as
+// a single row or column; decoding it to gray makes libjpeg skip the chroma
+// planes altogether.
+static bool to_luma(cv::Mat& mat)
+{
+    cv::Mat ret;
+
+    if (mat.type() == CV_8UC1 && (mat.rows == 1 || mat.cols == 1))
+        ret = cv::imdecode(mat, cv::IMREAD_GRAYSCALE);
+    else switch (mat.channels())
+    {
+    case 1: return true;
+    case 2: cv::cvtColor(mat, ret, cv::COLOR_YUV2GRAY_YUY2); break;
+    case 3: cv::cvtColor(mat, ret, cv::COLOR_BGR2GRAY); break;
+    case 4: cv::cvtColor(mat, ret, cv::COLOR_BGRA2GRAY); break;
+    default: break;
+    }
+
+    mat = ret;
+    return !mat.empty();
+}
+
+// A grab normally waits for the sensor. When we come back more than a
+// frame late, whatever the driver queued meanwhile comes out at once, so
+// grab until one has to be waited for, and only decode that one. Grabs
+// are only timed after a late return; waiting less than a frame for a
+// fresh one is normal otherwise.
+bool device::read_latest(cv::Mat& mat, unsigned& skipped, Timer& grabbed)
+{
+    const bool late = since_grab.elapsed_ms() > frame_ms * 1.5;
+    const double queued_ms = std::min(2., frame_ms / 8);
+
+    skipped = 0;
+
+    for (;;)
+    {
+        Timer t;
+        if (!cap.grab())
+            return false;
+        since_grab.start();
+        if (!late || t.elapsed_ms() >= queued_ms || skipped == max_skipped)
+            break;
+        skipped++;
+    }
+
+    grabbed.start();
+
+    return cap.retrieve(mat) && !mat.empty();
+}
+
+void device::run()
+{
+    thread_monitor monitor("capture " + name);
+    int failures = 0;
+    since_grab.start();
+
+    while (!isInterruptionRequested())
+    {
+        // fresh buffer every time; the previous one may still be held by
+        // a subscriber.
+        cv::Mat mat;
+        unsigned skipped = 0;
+        Timer grabbed;
+        bool ok;
+
+        {
+            QMutexLocker l(&cap_mtx);
+            if (params.latest)
+                ok = read_latest(mat, skipped, grabbed);
+            else
+            {
+                ok = cap.read(mat) && !mat.empty();
+                grabbed.start();
+            }
+        }
+
+        if (ok && params.luma)
+            ok = to_luma(mat);
+
+        if (!ok)
+        {
+            if (++failures >= max_failures)
+            {
+                qDebug() << "video: can't read from" << name;
+                break;
+            }
+            portable::sleep(1);
+            continue;
+        }
+
+        failures = 0;
+
+        QMutexLocker l(&mtx);
+        frame_ptr f = std::make_shared<frame>(frame { std::move(mat), ++seq, skipped, grabbed });
+
+        for (subscription* s : subscribers)
+        {
+            if (s->pending)
+                s->dropped_++;
+            s->pending = f;
+        }
+
+        cond.wakeAll();
+        monitor.tick();
+    }
+
+    {
+        QMutexLocker l(&cap_mtx);
+        cap.release();
+    }
+
+    QMutexLocker l(&mtx);
+    running = false;
+    cond.wakeAll();
+}
+
+subscription::subscription(std::shared_ptr<device> dev_) : dev(std::move(dev_))
+{
+    QMutexLocker l(&dev->mtx);
+    dev->subscribers.push_back(this);
+}
+
+subscription::~subscription()
+{
+    registry& r = get_registry();
+    QMutexLocker l(&r.mtx);
+
+    bool last;
+
+    {
+        QMutexLocker l2(&dev->mtx);
+        auto& subs = dev->subscribers;
+        subs.erase(std::remove(subs.begin(), subs.end(), this), subs.end());
+        last = subs.empty();
+    }
+
+    if (last)
+    {
+        // close before letting go of the registry lock, otherwise a new
+        // subscriber could try to open the device while it's still busy.
+        dev->stop();
+        auto it = r.devices.find(dev->params.idx);
+        if (it != r.devices.end() && it->second == dev)
+            r.devices.erase(it);
+    }
+}
+
+frame_ptr subscription::next(int timeout_ms)
+{
+    QMutexLocker l(&dev->mtx);
+
+    if (!pending && dev->running)
+        dev->cond.wait(&dev->mtx, (unsigned long)std::max(0, timeout_ms));
+
+    return std::exchange(pending, nullptr);
+}
+
+unsigned long long subscription::dropped() const
+{
+    QMutexLocker l(&dev->mtx);
+    return dropped_;
+}
+
+bool subscription::is_open() const
+{
+    QMutexLocker l(&dev->mtx);
+    return dev->running;
+}
+
+capture_params subscription::params() const
+{
+    return dev->params;
+}
+
+QString subscription::name() const
+{
+    return dev->name;
+}
+
+bool subscription::show_settings()
+{
+    QMutexLocker l(&dev->cap_mtx);
+    return video_property_page::show_from_capture(dev->cap, dev->params.idx);
+}
+
+subscription_ptr subscribe(const capture_params& params)
+{
+    if (params.idx < 0)
+        return nullptr;
+
+    registry& r = get_registry();
+    QMutexLocker l(&r.mtx);
+
+    std::shared_ptr<device>& dev = r.devices[params.idx];
+
+    if (dev)
+    {
+        bool running;
+        {
+            QMutexLocker l2(&dev->mtx);
+            running = dev->running;
+        }
+
+        if (running)
+        {
+            if (dev->params != params)
+                qDebug() << "video: camera" << dev->name << "already open"
+                         << "with different settings, sharing it as-is";
+            return std::make_shared<subscription>(dev);
+        }
+
+        // stale entry left after a read error; its subscribers keep the
+        // old device alive until they resubscribe.
+        dev = nullptr;
+    }
+
+    auto d = std::make_shared<device>(params);
+
+    if (!d->open())
+    {
+        r.devices.erase(params.idx);
+        return nullptr;
+    }
+
+    dev = d;
+    return std::make_shared<subscription>(dev);
+}
+
+} // ns video
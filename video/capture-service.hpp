@@ -0,0 +1,88 @@
+#pragma once
+
+// One capture thread per camera, shared by every tracker that opens it.
+// Frames are decoded once and handed out as immutable, reference-counted
+// buffers. Each subscriber keeps only the newest frame; frames it didn't
+// get to in time are counted as dropped.
+//
+// With `latest' set, the driver queue is kept as short as the backend
+// allows, and frames that queued up while the capture thread was late are
+// skipped without being decoded.
+//
+// With `luma' set, MJPEG is requested and only the luminance is decoded;
+// frames are then single-channel. Cameras that won't do MJPEG still give
+// grayscale frames, just converted the expensive way.
+
+#include "export.hpp"
+#include "compat/timer.hpp"
+
+#include <memory>
+
+#include <opencv2/core.hpp>
+
+#include <QString>
+
+namespace video {
+
+struct capture_params final
+{
+    int idx = -1, fps = 0, res_x = 0, res_y = 0;
+    bool latest = false, luma = false;
+
+    bool operator==(const capture_params& x) const;
+    bool operator!=(const capture_params& x) const { return !(*this == x); }
+};
+
+struct frame final
+{
+    // read-only. consumers must clone before drawing on it.
+    // CV_8UC1 when opened with `luma', CV_8UC3 otherwise.
+    cv::Mat mat;
+    unsigned long long seq = 0;
+    // queued frames thrown away right before this one
+    unsigned skipped = 0;
+    // started when the backend handed the frame over
+    Timer grabbed;
+
+    double age_ms() const { return grabbed.elapsed_ms(); }
+};
+
+using frame_ptr = std::shared_ptr<const frame>;
+
+struct device;
+
+class OTR_VIDEO_EXPORT subscription final
+{
+    friend struct device;
+
+    std::shared_ptr<device> dev;
+    frame_ptr pending;
+    unsigned long long dropped_ = 0;
+
+public:
+    explicit subscription(std::shared_ptr<device> dev);
+    ~subscription();
+
+    subscription(const subscription&) = delete;
+    subscription& operator=(const subscription&) = delete;
+
+    // waits up to `timeout_ms' for a frame newer than the last one taken.
+    // returns null on timeout or once the device stopped delivering.
+    frame_ptr next(int timeout_ms);
+    unsigned long long dropped() const;
+
+    bool is_open() const;
+    // params the device was opened with; may differ from what this
+    // subscriber asked for if another tracker opened it first.
+    capture_params params() const;
+    QString name() const;
+
+    bool show_settings();
+};
+
+using subscription_ptr = std::shared_ptr<subscription>;
+
+// opens the device on the first subscription, closes it with the last one.
+OTR_VIDEO_EXPORT subscription_ptr subscribe(const capture_params& params);
+
+} // ns video